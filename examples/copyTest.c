@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <redfish.h>
+
+/** A resource the test service answers with **/
+typedef struct
+{
+    const char* uri;
+    const char* body;
+} testResource;
+
+static testResource resources[] = {
+    {"/redfish/v1", "{\"@odata.id\": \"/redfish/v1\", \"Systems\": {\"@odata.id\": \"/redfish/v1/Systems\"}}"},
+    {"/redfish/v1/Systems", "{\"@odata.id\": \"/redfish/v1/Systems\", \"Members@odata.count\": 3, \"Members\": ["
+                            "{\"@odata.id\": \"/redfish/v1/Systems/0\"}, {\"@odata.id\": \"/redfish/v1/Systems/1\"}, {\"@odata.id\": \"/redfish/v1/Systems/2\"}]}"},
+    {"/redfish/v1/Systems/0", "{\"@odata.id\": \"/redfish/v1/Systems/0\", \"Id\": \"0\", \"MemoryGB\": 16}"},
+    {"/redfish/v1/Systems/1", "{\"@odata.id\": \"/redfish/v1/Systems/1\", \"Id\": \"1\", \"MemoryGB\": 32}"},
+    {"/redfish/v1/Systems/2", "{\"@odata.id\": \"/redfish/v1/Systems/2\", \"Id\": \"2\", \"MemoryGB\": 64}"},
+    {NULL, NULL}
+};
+
+typedef struct
+{
+    volatile int done;
+    int failed;
+} testResult;
+
+static void* serveRequests(void* arg)
+{
+    int listenSock = *(int*)arg;
+    int sock;
+    char request[4096];
+    char response[4096];
+    char uri[256];
+    ssize_t length;
+    size_t uriLength;
+    const char* body;
+    size_t i;
+
+    while((sock = accept(listenSock, NULL, NULL)) >= 0)
+    {
+        length = recv(sock, request, sizeof(request)-1, 0);
+        if(length > 0)
+        {
+            request[length] = 0;
+            uri[0] = 0;
+            sscanf(request, "%*s %255s", uri);
+            uriLength = strcspn(uri, "?");
+            while(uriLength > 1 && uri[uriLength-1] == '/')
+            {
+                uriLength--;
+            }
+            uri[uriLength] = 0;
+            body = NULL;
+            for(i = 0; resources[i].uri; i++)
+            {
+                if(strcmp(resources[i].uri, uri) == 0)
+                {
+                    body = resources[i].body;
+                    break;
+                }
+            }
+            if(body)
+            {
+                snprintf(response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n%s", strlen(body), body);
+            }
+            else
+            {
+                snprintf(response, sizeof(response), "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            }
+            send(sock, response, strlen(response), 0);
+        }
+        close(sock);
+    }
+    return NULL;
+}
+
+static int startService(unsigned short* port)
+{
+    int sock;
+    struct sockaddr_in addr;
+    socklen_t addrLength = sizeof(addr);
+
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if(sock < 0)
+    {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if(bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(sock, 16) != 0 || getsockname(sock, (struct sockaddr*)&addr, &addrLength) != 0)
+    {
+        close(sock);
+        return -1;
+    }
+    *port = ntohs(addr.sin_port);
+    return sock;
+}
+
+static void gotCollection(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    testResult* result = (testResult*)context;
+    redfishPayload* copy;
+    char* before;
+    char* after;
+
+    if(success == false || payload == NULL || getCollectionSize(payload) != 2)
+    {
+        fprintf(stderr, "Unexpected collection. success = %u, httpCode = %u\n", success, httpCode);
+        result->failed = 1;
+        cleanupPayload(payload);
+        result->done = 1;
+        return;
+    }
+    //The collection is built from members parsed into their own arenas, the copy has to keep its tree after the original is gone
+    copy = copyRedfishPayload(payload);
+    before = payloadToString(payload, false);
+    cleanupPayload(payload);
+    after = payloadToString(copy, false);
+    if(before == NULL || after == NULL || strcmp(before, after) != 0)
+    {
+        fprintf(stderr, "Copy changed when the original was cleaned up\n");
+        result->failed = 1;
+    }
+    free(before);
+    free(after);
+    cleanupPayload(copy);
+    result->done = 1;
+}
+
+int main(void)
+{
+    int sock;
+    unsigned short port;
+    pthread_t thread;
+    char host[64];
+    redfishService* service;
+    redfishAsyncOptions options;
+    testResult result;
+
+    sock = startService(&port);
+    if(sock < 0)
+    {
+        fprintf(stderr, "Unable to start the test service\n");
+        return 1;
+    }
+    pthread_create(&thread, NULL, serveRequests, &sock);
+    snprintf(host, sizeof(host), "http://127.0.0.1:%u", port);
+
+    libredfishEnablePayloadArenas();
+    service = createServiceEnumerator(host, NULL, NULL, REDFISH_FLAG_SERVICE_NO_VERSION_DOC);
+    if(service == NULL)
+    {
+        fprintf(stderr, "Unable to create service enumerator\n");
+        return 1;
+    }
+    memset(&options, 0, sizeof(options));
+    memset(&result, 0, sizeof(result));
+    options.accept = REDFISH_ACCEPT_JSON;
+    options.flags = REDFISH_ASYNC_FLAG_ARENA;
+    if(getPayloadByPathAsync(service, "/Systems[MemoryGB<40]", &options, gotCollection, &result) == false)
+    {
+        fprintf(stderr, "Unable to start request\n");
+        return 1;
+    }
+    while(result.done == 0)
+    {
+        usleep(1000);
+    }
+    serviceDecRefAndWait(service);
+    shutdown(sock, SHUT_RDWR);
+    close(sock);
+    pthread_join(thread, NULL);
+    return result.failed;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
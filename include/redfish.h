@@ -17,6 +17,9 @@
 #include <redfishService.h>
 #include <redfishPayload.h>
 #include <redpath.h>
+#include <redfishCrawl.h>
+#include <redfishSnapshot.h>
+#include <redfishDiff.h>
 #include <entities/resource.h>
 #include <entities/chassis.h>
 
@@ -77,4 +80,28 @@ void REDFISH_EXPORT libredfishSetMemoryFunctions(libRedfishMallocFunc malloc_fun
 
 
 
+/**
+ * Allow payloads to allocate their JSON from a per-response arena (see REDFISH_ASYNC_FLAG_ARENA). This takes over jansson's
+ * allocation functions for the whole process. Outside of arena parsing they hand every allocation to the functions jansson had
+ * when this was called, so an application that sets its own with json_set_alloc_funcs() must do so before this call and never
+ * after it.
+ */
+void REDFISH_EXPORT libredfishEnablePayloadArenas(void);
+/**
+ * Share common string values (enum values like "OK" or "Enabled", Ids, and @odata.type values) between all parsed payloads
+ * instead of giving each payload its own copy. The shared values are immutable and live for the life of the process. Object keys are
+ * always copied by jansson and so are not shared. Only payloads parsed into an arena (see REDFISH_ASYNC_FLAG_ARENA) share values,
+ * since their JSON is already read only and is copied before any change. This should be set before any requests are started.
+ *
+ * @param enable True to share values for payloads parsed from now on, false to stop
+ */
+void REDFISH_EXPORT libredfishSetValueInterning(bool enable);
+/**
+ * Keep the parsed form of recently used RedPath strings so that evaluating the same path again (see getPayloadByPath() and
+ * getPayloadForPathString()) skips parsing it. Parsed paths are immutable and shared by every call using them. The cache is off by
+ * default and this should be set before any requests are started.
+ *
+ * @param size The most paths to keep, 0 turns the cache off
+ */
+void REDFISH_EXPORT libredfishSetRedPathCacheSize(size_t size);
 #endif
@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file redfishCrawl.h
+ * @brief File containing the interface for crawling every resource of a service.
+ *
+ * This file explains the interface for walking the @odata.id link graph of a service, reading each resource once and handing it
+ * to a callback as it arrives.
+ */
+#ifndef _REDFISH_CRAWL_H_
+#define _REDFISH_CRAWL_H_
+
+#include <redfishService.h>
+#include <redfishPayload.h>
+
+/** The depth passed to the crawl callback once the crawl has finished **/
+#define REDFISH_CRAWL_END ((unsigned int)-1)
+
+/**
+ * @brief Options for a crawl.
+ *
+ * All fields may be left 0 or NULL for the defaults.
+ */
+typedef struct
+{
+    /** The URI to start from, NULL starts from the service root **/
+    const char* rootUri;
+    /** The most links to follow from the starting resource, 0 means no limit **/
+    unsigned int maxDepth;
+    /** The most resource requests to have outstanding at once, 0 uses REDFISH_DEFAULT_MAX_IN_FLIGHT **/
+    unsigned int maxInFlight;
+    /** A NULL terminated list of property names whose links are not followed, i.e. "LogServices". NULL follows every link **/
+    const char** skipProperties;
+    /** The options for each resource request, may be NULL **/
+    redfishAsyncOptions* options;
+} redfishCrawlOptions;
+
+/**
+ * Callback for each resource found by a crawl
+ *
+ * @param success Indicates if the resource was obtained or not
+ * @param httpCode The HTTP status code returned by the service for this resource
+ * @param payload The resource, it is the callback's responsibility to free it. NULL for the final call
+ * @param uri The URI of the resource, only valid during the call. NULL for the final call
+ * @param depth The number of links followed from the starting resource, or REDFISH_CRAWL_END for the final call
+ * @param context An opaque pointer sent to the original call
+ */
+typedef void (*redfishCrawlCallback)(bool success, unsigned short httpCode, redfishPayload* payload, const char* uri, unsigned int depth, void* context);
+
+/**
+ * @brief Read every resource reachable from a starting resource.
+ *
+ * Follow every @odata.id link from the starting resource, reading each URI once no matter how many resources link to it, and call
+ * the callback for each resource as it arrives. Resources are read in parallel so they are reported in no particular order. Once
+ * every resource has been reported the callback is called a final time with REDFISH_CRAWL_END, success is false if any resource
+ * could not be obtained. Only links to URIs on the same service (starting with '/') are followed.
+ *
+ * @param service The service to crawl
+ * @param options How to crawl, NULL uses the defaults. Only used during this call
+ * @param callback The function to call for each resource and when the crawl is done
+ * @param context An opaque data pointer to pass to the callback function
+ * @return false if the crawl could not be started, in which case the callback is not called. True otherwise
+ */
+REDFISH_EXPORT bool crawlServiceAsync(redfishService* service, redfishCrawlOptions* options, redfishCrawlCallback callback, void* context);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,77 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file redfishDiff.h
+ * @brief File containing the interface for comparing resources.
+ *
+ * This file explains the interface for finding the properties that differ between two versions of a resource, or between two
+ * snapshots of a service. Only the differences are reported, each one located by a JSON pointer (RFC 6901) into the resource.
+ */
+#ifndef _REDFISH_DIFF_H_
+#define _REDFISH_DIFF_H_
+
+#include <redfishService.h>
+#include <redfishPayload.h>
+#include <redfishSnapshot.h>
+
+/**
+ * @brief The kind of a difference.
+ */
+typedef enum {
+    /** The value is only in the newer resource **/
+    REDFISH_DIFF_ADDED,
+    /** The value is only in the older resource **/
+    REDFISH_DIFF_REMOVED,
+    /** The value is in both resources but is not the same **/
+    REDFISH_DIFF_CHANGED
+} redfishDiffType;
+
+/**
+ * Callback for each difference found
+ *
+ * @param type The kind of difference
+ * @param uri The URI of the resource that differs, may be NULL for diffPayloads()
+ * @param pointer The JSON pointer to the value that differs within the resource, "" for a whole resource
+ * @param before The older value, NULL for REDFISH_DIFF_ADDED. Only valid during the call
+ * @param after The newer value, NULL for REDFISH_DIFF_REMOVED. Only valid during the call
+ * @param context An opaque pointer sent to the original call
+ * @return true to continue, false to stop the diff
+ */
+typedef bool (*redfishDiffCallback)(redfishDiffType type, const char* uri, const char* pointer, json_t* before, json_t* after, void* context);
+
+/**
+ * @brief Report the differences between two versions of a resource
+ *
+ * Object members are matched by name and array elements by position. Members added to or removed from an object, and elements
+ * past the end of the shorter array, are reported as a whole. Two values of different types are reported as changed.
+ *
+ * @param before The older resource
+ * @param after The newer resource
+ * @param uri The URI passed to the callback, may be NULL
+ * @param callback The function to call for each difference
+ * @param context An opaque data pointer to pass to the callback function
+ * @return true if every difference was reported, false on error or if the callback stopped the diff
+ */
+REDFISH_EXPORT bool diffPayloads(redfishPayload* before, redfishPayload* after, const char* uri, redfishDiffCallback callback, void* context);
+
+/**
+ * @brief Report the differences between two snapshots
+ *
+ * Resources are matched by URI. A resource only in one snapshot is reported as a whole with the pointer "". Each snapshot records
+ * a content hash of every resource, so only resources whose hashes differ are compared at all, which makes the cost of a diff
+ * follow the number of changed resources rather than the size of the snapshots.
+ *
+ * @param before The older snapshot, such as an earlier crawl of the service
+ * @param after The newer snapshot
+ * @param callback The function to call for each difference, in URI order
+ * @param context An opaque data pointer to pass to the callback function
+ * @return true if every difference was reported, false on error or if the callback stopped the diff
+ */
+REDFISH_EXPORT bool diffSnapshots(redfishSnapshot* before, redfishSnapshot* after, redfishDiffCallback callback, void* context);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
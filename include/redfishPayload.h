@@ -14,6 +14,8 @@
 #ifndef _REDFISH_PAYLOAD_H_
 #define _REDFISH_PAYLOAD_H_
 
+#include <stdint.h>
+
 //redfishPayload is defined here...
 #include "redfishService.h"
 
@@ -67,13 +69,54 @@ REDFISH_EXPORT redfishPayload* createRedfishPayloadFromContent(const char* conte
 /**
  * @brief Create a copy of a Redfish Payload
  *
- * Create a new redfish payload with the same contents as the original payload
+ * Create a new redfish payload with the same contents as the original payload. The copy shares the original's JSON and
+ * raw content instead of duplicating them, a private copy is only made when either payload is changed with
+ * setPayloadElementByName() or setPayloadStringByName(). This must not be called on the same payload from more than one
+ * thread at a time.
  *
  * @param original The original payload data to copy.
  * @return A new redfish payload structure
  * @see cleanupPayload
  */
 REDFISH_EXPORT redfishPayload* copyRedfishPayload(const redfishPayload* original);
+/**
+ * @brief Get the JSON representation of the payload
+ *
+ * Return the JSON for the payload, parsing the raw response content first if the payload was obtained with
+ * REDFISH_BODY_LAZY and has not been parsed yet. Callers should use this instead of reading payload->json directly. This may
+ * be called from several threads reading the same payload, only one of them parses it. Changing the payload, or the JSON
+ * returned here, while other threads read it is not safe.
+ *
+ * @param payload The payload to obtain the JSON for
+ * @return The JSON for the payload (owned by the payload) or NULL if the payload is not JSON or could not be parsed
+ */
+REDFISH_EXPORT json_t*         getPayloadJson(redfishPayload* payload);
+/**
+ * @brief Convert a payload to its compact read only form
+ *
+ * Replace the payload's JSON tree with a single contiguous tape. Frozen payloads use a fraction of the memory of the
+ * JSON tree, and payloads obtained from them share the tape instead of copying it, so a frozen payload is suited to
+ * being cached and read from many threads. The accessors and RedPath evaluation work directly on the tape. Calling
+ * getPayloadJson() on a frozen payload rebuilds the JSON tree for that payload.
+ *
+ * @param payload The payload to freeze
+ * @return True if the payload is now frozen, false if it is not JSON or the tape could not be built
+ */
+REDFISH_EXPORT bool            freezePayload(redfishPayload* payload);
+/**
+ * @brief Get a hash of the content of the payload
+ *
+ * Return a 64 bit hash of the payload's JSON that only changes when the content does, so a resource can be compared with an
+ * earlier copy without keeping that copy. The hash does not depend on the order of object members, on whether the payload is
+ * frozen or on the machine it is computed on. Properties that change on every read, such as timestamps or readings, can be
+ * left out so they do not mask an otherwise unchanged resource. The hash is computed in one pass each time this is called;
+ * frozen payloads are hashed in place. Payloads that are not JSON are hashed by their raw content.
+ *
+ * @param payload The payload to hash
+ * @param ignoreProperties NULL terminated list of property names to leave out wherever they appear (i.e. "@odata.etag"), may be NULL
+ * @return The hash, or 0 if the payload is NULL or its JSON could not be parsed
+ */
+REDFISH_EXPORT uint64_t        getPayloadHash(redfishPayload* payload, const char** ignoreProperties);
 
 /**
  * @brief Is the payload a Redfish Collection?
@@ -404,6 +447,43 @@ REDFISH_EXPORT bool            getPayloadForPathAsync(redfishPayload* payload, r
  * @see cleanupPayload
  */
 REDFISH_EXPORT bool            getPayloadForPathStringAsync(redfishPayload* payload, const char* string, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+
+/** Call the member callback for each member as soon as it has been obtained **/
+#define REDFISH_MEMBER_ORDER_COMPLETION 0
+/** Call the member callback for each member in the order the members appear in the collection **/
+#define REDFISH_MEMBER_ORDER_COLLECTION 1
+/** The index passed to the member callback once every member has been reported **/
+#define REDFISH_MEMBERS_END ((size_t)-1)
+
+/**
+ * Callback for each member of a collection
+ *
+ * @param success Indicates if the member was obtained or not
+ * @param httpCode The HTTP status code returned by the service for this member
+ * @param payload The member, it is the callback's responsibility to free it. NULL for the final call
+ * @param index The position of the member in the collection, or REDFISH_MEMBERS_END for the final call
+ * @param context An opaque pointer sent to the original call
+ */
+typedef void (*redfishMemberCallback)(bool success, unsigned short httpCode, redfishPayload* payload, size_t index, void* context);
+
+/**
+ * @brief Obtain each member of a collection asynchronously
+ *
+ * Obtain every member of a collection, calling the callback once for each member as it arrives rather than once all of them
+ * have arrived. After the last member the callback is called one more time with a NULL payload and an index of
+ * REDFISH_MEMBERS_END, success is false for that call if any member could not be obtained. The callback is never called
+ * for two members at once, and is called from the service's async thread after this returns, even for an empty collection.
+ *
+ * @param collection The collection to obtain the members of
+ * @param order REDFISH_MEMBER_ORDER_COMPLETION or REDFISH_MEMBER_ORDER_COLLECTION
+ * @param options The redfish options to use if needing to obtain another URI or NULL for defaults
+ * @param callback The callback to use for each member and for the end of the collection
+ * @param context An opaque data pointer to send to the callback
+ * @return True if the callback will be called. False otherwise.
+ * @see getPayloadByIndexAsync
+ * @see cleanupPayload
+ */
+REDFISH_EXPORT bool            getCollectionMembersAsync(redfishPayload* collection, int order, redfishAsyncOptions* options, redfishMemberCallback callback, void* context);
 /**
  * @brief PATCH a payload to the URI reresented by a target asynchronously.
  *
@@ -468,5 +548,97 @@ REDFISH_EXPORT redfishPayload* getPayloadByNodeNameNoNetwork(redfishPayload* pay
  */
 REDFISH_EXPORT redfishPayload* getPayloadByIndexNoNetwork(redfishPayload* payload, size_t index);
 
+/** A dotted property path such as "Status.Health" that has been parsed once for use against many payloads **/
+typedef struct _redfishPropertyPath redfishPropertyPath;
+
+/**
+ * @brief Parse a dotted property path
+ *
+ * Split a path such as "Status.Health" into its member names once so that it can be looked up in any number of
+ * payloads without being parsed again. A compiled path is never modified and may be shared between threads.
+ *
+ * @param path The dotted path, empty segments are ignored the same way getPayloadByNodeName() ignores them
+ * @return A new compiled path or NULL if the path has no segments or memory could not be allocated
+ * @see cleanupPropertyPath
+ */
+REDFISH_EXPORT redfishPropertyPath* compilePropertyPath(const char* path);
+
+/**
+ * @brief Free a compiled property path
+ *
+ * @param path The path to free
+ */
+REDFISH_EXPORT void cleanupPropertyPath(redfishPropertyPath* path);
+
+/**
+ * @brief Obtain the value at a compiled property path
+ *
+ * Unlike getPayloadByNodeName() the value is returned as is: strings are not wrapped in an object and navigation
+ * properties are not followed.
+ *
+ * @param payload The payload to look in
+ * @param path The compiled path
+ * @return The value as a new payload or NULL if it does not exist
+ */
+REDFISH_EXPORT redfishPayload* getPayloadByPropertyPath(redfishPayload* payload, const redfishPropertyPath* path);
+
+/**
+ * @brief Obtain the string at a compiled property path without allocating
+ *
+ * @param payload The payload to look in
+ * @param path The compiled path
+ * @return The string (owned by the payload and valid until it is changed or cleaned up) or NULL if it does not exist or is not a string
+ */
+REDFISH_EXPORT const char* getPayloadStringByPropertyPath(redfishPayload* payload, const redfishPropertyPath* path);
+
+/**
+ * @brief Obtain the integer at a compiled property path without allocating
+ *
+ * @param payload The payload to look in
+ * @param path The compiled path
+ * @param value Filled in with the integer
+ * @return True if the value exists and is an integer, false otherwise
+ */
+REDFISH_EXPORT bool getPayloadIntByPropertyPath(redfishPayload* payload, const redfishPropertyPath* path, json_int_t* value);
+
+/** An iterator over the children of a payload **/
+typedef struct _redfishPayloadIterator redfishPayloadIterator;
+
+/**
+ * @brief Start iterating over the children of a payload
+ *
+ * Create an iterator that visits every child of the payload once, in the same order as getPayloadByIndexNoNetwork().
+ * - If the payload is an array it will visit each element of the array.
+ * - If the payload is a collection it will visit each element in the Members element.
+ * - If the payload is an object it will visit each key in the object.
+ * Walking an object this way is linear in the number of keys, while calling getPayloadByIndex() for each key may not be.
+ * The iterator keeps its own reference to the payload's content, so the payload may be cleaned up while the iterator is in use.
+ *
+ * @param payload The payload to iterate over
+ * @return A new iterator or NULL if the payload is not an object, array, or collection
+ * @see payloadIteratorNext
+ * @see cleanupPayloadIterator
+ */
+REDFISH_EXPORT redfishPayloadIterator* createPayloadIterator(redfishPayload* payload);
+
+/**
+ * @brief Get the next child from an iterator
+ *
+ * Navigation properties are returned as is, no network requests are made.
+ *
+ * @param iterator The iterator to advance
+ * @param key Filled in with the key of the child for objects or NULL for arrays and collections, may be NULL. The key remains valid until the iterator is cleaned up.
+ * @param value Filled in with the child payload, which must be freed with cleanupPayload()
+ * @return True if a child was returned, false once all children have been visited
+ */
+REDFISH_EXPORT bool payloadIteratorNext(redfishPayloadIterator* iterator, const char** key, redfishPayload** value);
+
+/**
+ * @brief Free an iterator
+ *
+ * @param iterator The iterator to free
+ */
+REDFISH_EXPORT void cleanupPayloadIterator(redfishPayloadIterator* iterator);
+
 
 #endif
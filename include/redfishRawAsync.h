@@ -94,6 +94,8 @@ typedef struct _asyncHttpResponse
     size_t bodySize;
     /** The response payload body. char* is used for convience. Binary data can be passed and the bodySize parameter dictates the length **/
     char* body;
+    /** The time in microseconds from sending the request to receiving the whole response, 0 if unknown **/
+    unsigned long responseTime;
 } asyncHttpResponse;
 
 /**
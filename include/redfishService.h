@@ -49,18 +49,34 @@ typedef enum {
  * A structure representing a redfish payload to send or receive
  */
 typedef struct {
-    /** The json for the payload. Only valid if contentType is PAYLOAD_CONTENT_JSON **/
+    /** The json for the payload. Only valid if contentType is PAYLOAD_CONTENT_JSON. May be NULL until parsed, use getPayloadJson() **/
     json_t* json;
     /** The redfish service this payload was created by or should be sent to **/
     redfishService* service;
-    /** The raw payload content. Only valid if contentType is PAYLOAD_CONTENT_OTHER **/
+    /** The raw payload content. Valid if contentType is PAYLOAD_CONTENT_OTHER or if contentType is PAYLOAD_CONTENT_JSON and json has not been parsed yet, kept until cleanup once parsed **/
     char* content;
-    /** The raw payload lengh. Only valid if contentType is PAYLOAD_CONTENT_OTHER **/
+    /** The raw payload lengh. Valid whenever content is **/
     size_t contentLength;
     /** The content type of the payload **/
     redfishContentType contentType;
     /** The content type string. Only valid if contentType is PAYLOAD_CONTENT_OTHER **/
     char* contentTypeStr;
+    /** The arena the json was allocated from or NULL if it was allocated from the heap **/
+    struct _payloadArena* arena;
+    /** The frozen form of the payload, see freezePayload(). Only used while json is NULL, kept until cleanup once thawed **/
+    struct _payloadTape* tape;
+    /** The node in tape this payload refers to **/
+    size_t tapeNode;
+    /** Set once content is shared with copies of this payload, content is freed when the last of them lets go of it **/
+    struct _payloadContentShare* contentShare;
+    /** Built the first time a large object is accessed by index, maps an index to its key **/
+    struct _payloadObjectIndex* objectIndex;
+    /** The time in microseconds the service took to answer the request this payload was read with, 0 if it was not read from a service **/
+    unsigned long responseTime;
+    /** Set by copyRedfishPayload() once json is shared with a copy, inherited by children. Changes are made to a private copy while more than one copy shares it **/
+    struct _payloadJsonShare* jsonShare;
+    /** True if this payload is one of the copies counted by jsonShare, false for children of them **/
+    bool jsonShareCopy;
 } redfishPayload;
 
 /** The connection should use HTTP basic authentication to authenticate to the Redfish service**/
@@ -316,6 +332,36 @@ REDFISH_EXPORT void serviceDecRefAndWait(redfishService* service);
 /** Accept an XML response **/
 #define REDFISH_ACCEPT_XML  2
 
+/** Parse the response body into JSON before calling the callback **/
+#define REDFISH_BODY_PARSE 0
+/** Keep the raw response body and only parse it the first time the JSON is requested via getPayloadJson() **/
+#define REDFISH_BODY_LAZY  1
+/** Discard the response body, the callback will be given a NULL payload and only the status is reported **/
+#define REDFISH_BODY_SKIP  2
+
+//Values for redfishAsyncOptions.flags
+/**
+ * Allocate the JSON for each response from a single arena that is freed along with the payload (and any payloads obtained from it).
+ * Requires libredfishEnablePayloadArenas() to have been called, otherwise this flag is ignored. JSON obtained from such a payload
+ * is read only (setPayloadElementByName() will copy it first) and must not be used after the payload and any payloads obtained from it
+ * are cleaned up, even if a reference was taken with json_incref().
+ */
+#define REDFISH_ASYNC_FLAG_ARENA 0x00000001
+/**
+ * Return only the first page of a paged collection. By default the pages named by Members@odata.nextLink are read and their members
+ * appended to the collection before the callback is called.
+ */
+#define REDFISH_ASYNC_FLAG_NO_PAGING 0x00000002
+/**
+ * Complete a RedPath predicate on a collection or array (such as [Id=BMC]) with the first member found to match, instead of waiting for
+ * every member and returning all matches. Members are read in parallel, so the first to arrive is returned rather than the first in the
+ * collection. Use it when the predicate identifies a single member.
+ */
+#define REDFISH_ASYNC_FLAG_FIRST_MATCH 0x00000004
+
+/** The most member requests a RedPath predicate or getCollectionMembersAsync() keeps outstanding when maxInFlight is 0 **/
+#define REDFISH_DEFAULT_MAX_IN_FLIGHT 32
+
 /** Try Registering for events through SSE, if supported will be tried first **/
 #define REDFISH_REG_TYPE_SSE  1
 /** Try Registering for events through EventDestination POST **/
@@ -347,6 +393,22 @@ typedef struct
     int accept;
     /** The timeout for the operation, 0 means never timeout **/
     unsigned long timeout;
+    /** How to handle the response body, one of the REDFISH_BODY_* values. 0 (REDFISH_BODY_PARSE) keeps the historic behavior **/
+    int bodyHandling;
+    /** Any extra REDFISH_ASYNC_FLAG_* values for the call **/
+    unsigned int flags;
+    /** A comma separated list of properties to return ($select), '/' separates nested properties. NULL returns all properties **/
+    const char* select;
+    /** A $filter expression to apply to the members of a collection (eq, ne, gt, ge, lt, le, and, or, not). NULL returns all members **/
+    const char* filter;
+    /** The maximum number of members to return ($top), 0 returns all members **/
+    unsigned int top;
+    /** The number of members to skip ($skip), 0 skips none **/
+    unsigned int skip;
+    /** The most members to read from a paged collection, 0 reads every page. Members@odata.count is left as the service reported it **/
+    unsigned int maxMembers;
+    /** The most member requests to keep outstanding when a call reads every member of a collection or array, the next member is requested as each one completes. 0 uses REDFISH_DEFAULT_MAX_IN_FLIGHT **/
+    unsigned int maxInFlight;
 } redfishAsyncOptions;
 
 typedef struct
@@ -477,7 +539,8 @@ REDFISH_EXPORT bool deleteUriFromServiceAsync(redfishService* service, const cha
 /**
  * @brief Obtain the redfish service root.
  *
- * Obtain the redfish service root on the service asynchronously.
+ * Obtain the redfish service root on the service asynchronously. A root kept on the service (see setServiceRootLifetime())
+ * is still delivered on the async thread, never from within this call.
  *
  * @param service The service to obtain data from
  * @param version The redfish version to obtain the root of. Assumes "v1" if NULL.
@@ -487,6 +550,30 @@ REDFISH_EXPORT bool deleteUriFromServiceAsync(redfishService* service, const cha
  * @return false if the request could not be started. True otherwise
  */
 REDFISH_EXPORT bool getRedfishServiceRootAsync(redfishService* service, const char* version, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+
+/**
+ * @brief Set how long the service root is reused for.
+ *
+ * The service root is read once and kept on the service, so getRedfishServiceRoot(), getRedfishServiceRootAsync(), and every
+ * RedPath query after the first answer from the kept copy instead of requesting it again. Requests that use options changing
+ * the response ($select, $filter, $top, $skip, or skipping the body) always go to the service. The version document was
+ * already read once, when the service was created.
+ *
+ * @param service The service
+ * @param seconds How long a service root is used for after it is read. 0, the default, uses it until invalidateServiceRoot() is called
+ * @see invalidateServiceRoot
+ */
+REDFISH_EXPORT void setServiceRootLifetime(redfishService* service, unsigned int seconds);
+
+/**
+ * @brief Drop the kept copy of the service root.
+ *
+ * The next request for the service root goes to the service, i.e. after a firmware update changes what the service supports.
+ *
+ * @param service The service
+ * @see setServiceRootLifetime
+ */
+REDFISH_EXPORT void invalidateServiceRoot(redfishService* service);
 /**
  * @brief Obtain the redfish payload corresponding to the redpath.
  *
@@ -494,12 +581,69 @@ REDFISH_EXPORT bool getRedfishServiceRootAsync(redfishService* service, const ch
  *
  * @param service The service to obtain data from
  * @param path A redpath string to use to locate data.
- * @param options Options to use for this request or any subsequent requests triggered by this request. If NULL a resonable set of defaults will be used
+ * @param options Options to use for this request or any subsequent requests triggered by this request. The query options and maxMembers only apply to the resource at the end of the path. If NULL a resonable set of defaults will be used
  * @param callback A function to call upon completion of the request
  * @param context An opaque data pointer to pass to the callback function
  * @return false if the request could not be started. True otherwise
  */
 REDFISH_EXPORT bool getPayloadByPathAsync(redfishService* service, const char* path, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+
+/**
+ * @brief Remember where RedPath steps lead on a service.
+ *
+ * Once getPayloadByPathAsync() has followed a step that selects a single resource by name or index (i.e. "Systems", "[0]" and
+ * "Status" in "/Systems[0]/Status") the URI of the resource it led to is kept, so later paths starting the same way request that
+ * resource directly instead of every resource on the way to it. If a remembered resource returns 404 every step leading to it is
+ * forgotten and the path is followed again from the service root. Collection members can come and go, so while a step is
+ * remembered an index may lead to the member that was at that index when the step was taken.
+ *
+ * @param service The service
+ * @param seconds How long a step is remembered for. 0 turns the memo off, which is the default. Any steps already remembered are forgotten
+ * @see clearRedPathMemo
+ */
+REDFISH_EXPORT void setRedPathMemoLifetime(redfishService* service, unsigned int seconds);
+
+/**
+ * @brief Forget every RedPath step remembered for a service.
+ *
+ * @param service The service
+ * @see setRedPathMemoLifetime
+ */
+REDFISH_EXPORT void clearRedPathMemo(redfishService* service);
+
+/** The index passed to the paths callback once every path has been reported **/
+#define REDFISH_PATHS_END ((size_t)-1)
+
+/**
+ * Callback for each path of getPayloadsByPathsAsync()
+ *
+ * @param success Indicates if the payload for the path was obtained or not
+ * @param httpCode The HTTP status code returned by the service for the last request made for this path
+ * @param payload The payload for the path, it is the callback's responsibility to free it. NULL for the final call
+ * @param index The position of the path in the array given to getPayloadsByPathsAsync(), or REDFISH_PATHS_END for the final call
+ * @param context An opaque pointer sent to the original call
+ */
+typedef void (*redfishPathsCallback)(bool success, unsigned short httpCode, redfishPayload* payload, size_t index, void* context);
+
+/**
+ * @brief Obtain the redfish payloads corresponding to several redpaths.
+ *
+ * Obtain the payload for each redpath on the service asynchronously. Paths that start the same way share the requests for that
+ * part of the path, so the service root and any other resource on the way to more than one path (i.e. each chassis for
+ * "/Chassis[*]/Thermal" and "/Chassis[*]/Power") is only requested once. The callback is called once for each path as its payload
+ * arrives, in no particular order, and then a final time with REDFISH_PATHS_END. success is false for the final call if any path
+ * could not be obtained.
+ *
+ * @param service The service to obtain data from
+ * @param paths The redpath strings to use to locate data, only used during this call
+ * @param count The number of entries in paths
+ * @param options Options to use for every request made for the paths, only used during this call. The query options and maxMembers only apply to the resource at the end of each path. If NULL a resonable set of defaults will be used
+ * @param callback A function to call for each path and when every path has been reported
+ * @param context An opaque data pointer to pass to the callback function
+ * @return false if the paths could not be parsed or no request could be started, in which case the callback is not called. True
+ * otherwise, in which case the callback is only ever called after this returns, even for an empty list of paths
+ */
+REDFISH_EXPORT bool getPayloadsByPathsAsync(redfishService* service, const char** paths, size_t count, redfishAsyncOptions* options, redfishPathsCallback callback, void* context);
 /**
  * @brief Register for notification of async redfish events, with the registration done asynchronously.
  *
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file redfishSnapshot.h
+ * @brief File containing the interface for inventory snapshot files.
+ *
+ * This file explains the interface for saving a set of resources, keyed by URI, to a binary file and reading them back. Each
+ * resource is stored in the frozen payload form (see freezePayload()) and the file is memory mapped when opened, so payloads
+ * read from a snapshot are used in place without parsing. Snapshot files use the byte order of the machine that wrote them and
+ * are trusted when read.
+ */
+#ifndef _REDFISH_SNAPSHOT_H_
+#define _REDFISH_SNAPSHOT_H_
+
+#include <redfishService.h>
+#include <redfishPayload.h>
+
+/** Pass as the latency to createServiceFromSnapshot() to answer each resource after the responseTime it was read with **/
+#define REDFISH_REPLAY_RECORDED_LATENCY ((unsigned long)-1)
+
+/** A snapshot file being written **/
+typedef struct _redfishSnapshotWriter redfishSnapshotWriter;
+/** An open snapshot file **/
+typedef struct _redfishSnapshot redfishSnapshot;
+
+/**
+ * @brief Start writing a snapshot file
+ *
+ * The file is written alongside the destination and only replaces it once closeSnapshotWriter() succeeds.
+ *
+ * @param fileName The snapshot file to create or replace
+ * @return A new writer or NULL on failure
+ * @see closeSnapshotWriter
+ */
+REDFISH_EXPORT redfishSnapshotWriter* createSnapshotWriter(const char* fileName);
+
+/**
+ * @brief Add a resource to a snapshot
+ *
+ * The payload is written out immediately and is not retained. Adding a URI a second time replaces the earlier resource. The
+ * payload's responseTime is kept with it so a replay service can answer as slowly as the service did.
+ *
+ * @param writer The writer
+ * @param uri The URI to store the resource under
+ * @param payload The resource, must be JSON
+ * @return false if the resource could not be written
+ */
+REDFISH_EXPORT bool addSnapshotPayload(redfishSnapshotWriter* writer, const char* uri, redfishPayload* payload);
+
+/**
+ * @brief Finish a snapshot file
+ *
+ * Write the URI index, replace the destination file with the new one and free the writer.
+ *
+ * @param writer The writer, freed by this call
+ * @return false if the snapshot could not be written, in which case the destination file is left as it was
+ */
+REDFISH_EXPORT bool closeSnapshotWriter(redfishSnapshotWriter* writer);
+
+/**
+ * @brief Open a snapshot file
+ *
+ * @param fileName The snapshot file
+ * @param service The service to associate the payloads with, may be NULL for offline use
+ * @return The snapshot or NULL if the file could not be opened or is not a snapshot
+ * @see cleanupSnapshot
+ */
+REDFISH_EXPORT redfishSnapshot* openSnapshot(const char* fileName, redfishService* service);
+
+/**
+ * @brief Get a resource from a snapshot
+ *
+ * The payload is frozen and reads the mapped file directly.
+ *
+ * @param snapshot The snapshot
+ * @param uri The URI the resource was stored under
+ * @return A new payload or NULL if the snapshot has no such URI
+ * @see cleanupPayload
+ */
+REDFISH_EXPORT redfishPayload* getSnapshotPayload(redfishSnapshot* snapshot, const char* uri);
+
+/**
+ * @brief Get the number of resources in a snapshot
+ *
+ * @param snapshot The snapshot
+ * @return The number of resources
+ */
+REDFISH_EXPORT size_t getSnapshotCount(redfishSnapshot* snapshot);
+
+/**
+ * @brief Get a URI stored in a snapshot
+ *
+ * URIs are in sorted order.
+ *
+ * @param snapshot The snapshot
+ * @param index The position of the URI, less than getSnapshotCount()
+ * @return The URI, valid until cleanupSnapshot() is called, or NULL if index is out of range
+ */
+REDFISH_EXPORT const char* getSnapshotUri(redfishSnapshot* snapshot, size_t index);
+
+/**
+ * @brief Close a snapshot
+ *
+ * Payloads already obtained from the snapshot stay valid, the file is unmapped once the last of them is cleaned up.
+ *
+ * @param snapshot The snapshot
+ */
+REDFISH_EXPORT void cleanupSnapshot(redfishSnapshot* snapshot);
+
+/**
+ * @brief Create a service that answers every request from a snapshot
+ *
+ * The service never opens a connection, its async thread answers GET and HEAD requests with the resource stored under the URI,
+ * 404 if there is none and 405 for any other method. Every other call, including the RedPath and entity helpers, works unchanged
+ * against the service, which makes it possible to reproduce and time a workload without the system it was captured from. Query
+ * options are always applied by the library as the snapshot only holds whole resources. A URI with a query string, i.e. a
+ * nextLink, is only answered if it was stored with that query string, and a trailing '/' on the path is ignored. GET requests
+ * made through the redfish calls get the stored resource as is, without reparsing it.
+ *
+ * @param snapshot The snapshot, the service holds its own reference so the caller may clean it up at any time
+ * @param latency The time in microseconds to wait before answering each request, 0 answers at once. REDFISH_REPLAY_RECORDED_LATENCY
+ * waits as long as the service took to answer when each resource was read. Each request waits on its own, so requests made
+ * together are answered together
+ * @param flags Flags about the service, see createServiceEnumerator()
+ * @return The service or NULL if the snapshot has no service root
+ * @see serviceDecRef
+ */
+REDFISH_EXPORT redfishService* createServiceFromSnapshot(redfishSnapshot* snapshot, unsigned long latency, unsigned int flags);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,422 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <jansson.h>
+#ifdef _MSC_VER
+#include <windows.h>
+#include <malloc.h>
+#endif
+
+#include "arena.h"
+#include "queue.h"
+#include "debug.h"
+
+/** log2 of ARENA_CHUNK_SIZE **/
+#define ARENA_CHUNK_SHIFT 14
+/** The size and alignment of each block of memory obtained for an arena, larger allocations get a block of their own **/
+#define ARENA_CHUNK_SIZE  (1 << ARENA_CHUNK_SHIFT)
+/** The number of span bits resolved by the top level of the chunk map **/
+#define ARENA_MAP_ROOT_BITS 10
+/** The number of span bits resolved by the middle level of the chunk map **/
+#define ARENA_MAP_MID_BITS  12
+/** The number of span bits resolved by the leaves of the chunk map **/
+#define ARENA_MAP_LEAF_BITS 12
+/** The chunk map covers the first 2^48 bytes of address space, chunks above that are not used for arenas **/
+#define ARENA_MAP_SPAN_BITS (ARENA_MAP_ROOT_BITS + ARENA_MAP_MID_BITS + ARENA_MAP_LEAF_BITS)
+
+#ifdef _MSC_VER
+/** Make the contents of a new chunk map node visible before the node itself **/
+#define arenaMapPublish() MemoryBarrier()
+#else
+/** Make the contents of a new chunk map node visible before the node itself **/
+#define arenaMapPublish() __sync_synchronize()
+#endif
+
+#ifdef _MSC_VER
+/** Get memory aligned to ARENA_CHUNK_SIZE **/
+#define arenaChunkAlloc(size) _aligned_malloc((size), ARENA_CHUNK_SIZE)
+/** Free memory from arenaChunkAlloc() **/
+#define arenaChunkFree(ptr)   _aligned_free(ptr)
+#else
+/** Get memory aligned to ARENA_CHUNK_SIZE **/
+#define arenaChunkAlloc(size) aligned_alloc(ARENA_CHUNK_SIZE, (size))
+/** Free memory from arenaChunkAlloc() **/
+#define arenaChunkFree(ptr)   free(ptr)
+#endif
+
+/** Used to keep every arena allocation aligned for any jansson type **/
+typedef union
+{
+    /** Alignment only **/
+    double alignDouble;
+    /** Alignment only **/
+    long long alignLongLong;
+    /** Alignment only **/
+    void* alignPointers[2];
+} arenaAlign;
+
+/** A block of memory owned by an arena **/
+typedef struct _arenaChunk
+{
+    /** The next chunk in the arena **/
+    struct _arenaChunk* next;
+    /** The number of usable bytes in this chunk **/
+    size_t size;
+    /** Alignment only, the chunk data follows this structure **/
+    arenaAlign align;
+} arenaChunk;
+
+struct _payloadArena
+{
+    /** The number of payloads (or other arenas) using this arena **/
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 refCount;
+#else
+    LONG refCount;
+#endif
+#else
+    size_t refCount;
+#endif
+    /** All the chunks obtained for this arena, the first one is the current one **/
+    arenaChunk* chunks;
+    /** The next free byte in the current chunk **/
+    char* next;
+    /** The number of free bytes left in the current chunk **/
+    size_t left;
+    /** Other arenas this one keeps alive **/
+    payloadArena** adopted;
+    /** The number of entries in adopted **/
+    size_t adoptedCount;
+};
+
+/**
+ * @brief A leaf of the chunk map.
+ *
+ * Chunks are aligned to ARENA_CHUNK_SIZE, so the address of any arena allocation divided by ARENA_CHUNK_SIZE names the
+ * span of the chunk it came from. An oversized chunk sets the owner of each ARENA_CHUNK_SIZE span it covers.
+ */
+typedef struct
+{
+    /** The arena owning each span, NULL if the span is not (or no longer) part of an arena chunk **/
+    payloadArena* volatile arenas[1 << ARENA_MAP_LEAF_BITS];
+} arenaMapLeaf;
+
+/** The middle level of the chunk map **/
+typedef struct
+{
+    /** The leaves, NULL where no arena chunk was ever placed **/
+    arenaMapLeaf* volatile leaves[1 << ARENA_MAP_MID_BITS];
+} arenaMapMid;
+
+static void* arenaMalloc(size_t size);
+static void arenaFree(void* ptr);
+static void* arenaAllocate(payloadArena* arena, size_t size);
+static void arenaDestroy(payloadArena* arena);
+static payloadArena* arenaOwner(const void* ptr);
+static bool arenaMapSet(arenaChunk* chunk, size_t chunkBytes, payloadArena* arena);
+
+static bool gArenaAllocatorInstalled = false;
+/** The allocation functions jansson used before the arena allocator was installed, used for everything outside an arena **/
+static json_malloc_t gHeapMalloc = NULL;
+/** The free function matching gHeapMalloc **/
+static json_free_t gHeapFree = NULL;
+/** Serializes changes to the chunk map, lookups don't take it **/
+static mutex gArenaMapLock;
+/**
+ * The owner of every span of memory that is part of an arena chunk. Nodes are only ever added, never freed or moved, so the
+ * owner of any pointer jansson frees is found with three reads and no lock.
+ */
+static arenaMapMid* volatile gArenaMap[1 << ARENA_MAP_ROOT_BITS];
+
+#ifdef _MSC_VER
+static __declspec(thread) payloadArena* gCurrentArena = NULL;
+#else
+static __thread payloadArena* gCurrentArena = NULL;
+#endif
+
+void arenaInstallAllocator(void)
+{
+    if(gArenaAllocatorInstalled == false)
+    {
+        mutex_init(&gArenaMapLock);
+        //Chain to whatever jansson allocated with before, normally malloc()/free()
+        json_get_alloc_funcs(&gHeapMalloc, &gHeapFree);
+        json_set_alloc_funcs(arenaMalloc, arenaFree);
+        gArenaAllocatorInstalled = true;
+    }
+}
+
+payloadArena* arenaCreate(void)
+{
+    payloadArena* ret;
+
+    if(gArenaAllocatorInstalled == false)
+    {
+        return NULL;
+    }
+    ret = (payloadArena*)calloc(1, sizeof(payloadArena));
+    if(ret == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to allocate arena!\n", __func__);
+        return NULL;
+    }
+    ret->refCount = 1;
+    return ret;
+}
+
+payloadArena* arenaIncRef(payloadArena* arena)
+{
+    if(arena == NULL)
+    {
+        return NULL;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    InterlockedIncrement64(&(arena->refCount));
+#else
+    InterlockedIncrement(&(arena->refCount));
+#endif
+#else
+    __sync_fetch_and_add(&(arena->refCount), 1);
+#endif
+    return arena;
+}
+
+void arenaDecRef(payloadArena* arena)
+{
+    size_t newCount;
+
+    if(arena == NULL)
+    {
+        return;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    newCount = InterlockedDecrement64(&(arena->refCount));
+#else
+    newCount = InterlockedDecrement(&(arena->refCount));
+#endif
+#else
+    newCount = __sync_sub_and_fetch(&(arena->refCount), 1);
+#endif
+    if(newCount == 0)
+    {
+        arenaDestroy(arena);
+    }
+}
+
+bool arenaAdopt(payloadArena* arena, payloadArena* other)
+{
+    payloadArena** tmp;
+
+    if(arena == NULL || other == NULL || arena == other)
+    {
+        return true;
+    }
+    tmp = (payloadArena**)realloc(arena->adopted, sizeof(payloadArena*)*(arena->adoptedCount+1));
+    if(tmp == NULL)
+    {
+        return false;
+    }
+    arena->adopted = tmp;
+    arena->adopted[arena->adoptedCount++] = arenaIncRef(other);
+    return true;
+}
+
+payloadArena* arenaSetCurrent(payloadArena* arena)
+{
+    payloadArena* ret = gCurrentArena;
+    gCurrentArena = arena;
+    return ret;
+}
+
+bool arenaContains(payloadArena* arena, const void* ptr)
+{
+    if(arena == NULL || ptr == NULL)
+    {
+        return false;
+    }
+    return (arenaOwner(ptr) == arena);
+}
+
+static void* arenaMalloc(size_t size)
+{
+    if(gCurrentArena)
+    {
+        return arenaAllocate(gCurrentArena, size);
+    }
+    //Outside of an arena parse this has to be the previous allocator so that callers can free() json_dumps() output like always
+    return gHeapMalloc(size);
+}
+
+static void arenaFree(void* ptr)
+{
+    //Everything jansson frees while an arena is current (lexer buffers, outgrown hash tables) came from the arena and is
+    //released all at once by arenaDestroy(). Arena memory can also show up here with no arena current, such as a value
+    //replaced in a parsed tree, and has to be left for arenaDestroy() as well
+    if(gCurrentArena == NULL && arenaOwner(ptr) == NULL)
+    {
+        gHeapFree(ptr);
+    }
+}
+
+static void* arenaAllocate(payloadArena* arena, size_t size)
+{
+    arenaChunk* chunk;
+    size_t chunkBytes;
+    size_t chunkSize;
+    void* ret;
+
+    //Round up so the next allocation stays aligned
+    size = (size + sizeof(arenaAlign) - 1) & ~(sizeof(arenaAlign) - 1);
+    if(size > arena->left)
+    {
+        //Whole ARENA_CHUNK_SIZE spans so the chunk map can cover the chunk exactly
+        chunkBytes = (sizeof(arenaChunk) + size + ARENA_CHUNK_SIZE - 1) & ~((size_t)ARENA_CHUNK_SIZE - 1);
+        chunkSize = chunkBytes - sizeof(arenaChunk);
+        chunk = (arenaChunk*)arenaChunkAlloc(chunkBytes);
+        if(chunk == NULL)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to allocate arena chunk!\n", __func__);
+            return NULL;
+        }
+        if(arenaMapSet(chunk, chunkBytes, arena) == false)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to track arena chunk!\n", __func__);
+            arenaChunkFree(chunk);
+            return NULL;
+        }
+        chunk->size = chunkSize;
+        if(chunkBytes > ARENA_CHUNK_SIZE && arena->chunks != NULL)
+        {
+            //Oversized allocation, keep using the current chunk for the small stuff
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+            return (void*)(chunk+1);
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->next = (char*)(chunk+1);
+        arena->left = chunkSize;
+    }
+    ret = arena->next;
+    arena->next += size;
+    arena->left -= size;
+    return ret;
+}
+
+static void arenaDestroy(payloadArena* arena)
+{
+    arenaChunk* chunk;
+    arenaChunk* next;
+    size_t i;
+
+    chunk = arena->chunks;
+    while(chunk)
+    {
+        next = chunk->next;
+        arenaMapSet(chunk, sizeof(arenaChunk) + chunk->size, NULL);
+        arenaChunkFree(chunk);
+        chunk = next;
+    }
+    for(i = 0; i < arena->adoptedCount; i++)
+    {
+        arenaDecRef(arena->adopted[i]);
+    }
+    free(arena->adopted);
+    free(arena);
+}
+
+/*Find the arena that owns a pointer, NULL for heap memory*/
+static payloadArena* arenaOwner(const void* ptr)
+{
+    uint64_t span = (uint64_t)(uintptr_t)ptr >> ARENA_CHUNK_SHIFT;
+    arenaMapMid* mid;
+    arenaMapLeaf* leaf;
+
+    if(ptr == NULL || (span >> ARENA_MAP_SPAN_BITS) != 0)
+    {
+        return NULL;
+    }
+    mid = gArenaMap[span >> (ARENA_MAP_MID_BITS + ARENA_MAP_LEAF_BITS)];
+    if(mid == NULL)
+    {
+        return NULL;
+    }
+    leaf = mid->leaves[(span >> ARENA_MAP_LEAF_BITS) & ((1 << ARENA_MAP_MID_BITS) - 1)];
+    if(leaf == NULL)
+    {
+        return NULL;
+    }
+    return leaf->arenas[span & ((1 << ARENA_MAP_LEAF_BITS) - 1)];
+}
+
+/*Record (or with a NULL arena forget) the owner of every span in a chunk*/
+static bool arenaMapSet(arenaChunk* chunk, size_t chunkBytes, payloadArena* arena)
+{
+    uint64_t start = (uint64_t)(uintptr_t)chunk >> ARENA_CHUNK_SHIFT;
+    uint64_t end = start + chunkBytes / ARENA_CHUNK_SIZE;
+    uint64_t span;
+    arenaMapMid* mid;
+    arenaMapLeaf* leaf;
+    size_t rootIndex;
+    size_t midIndex;
+
+    if((end >> ARENA_MAP_SPAN_BITS) != 0)
+    {
+        //Nothing outside the map is ever recorded, so there is nothing to forget either
+        return (arena == NULL);
+    }
+    mutex_lock(&gArenaMapLock);
+    for(span = start; span < end; span++)
+    {
+        rootIndex = (size_t)(span >> (ARENA_MAP_MID_BITS + ARENA_MAP_LEAF_BITS));
+        midIndex = (size_t)(span >> ARENA_MAP_LEAF_BITS) & ((1 << ARENA_MAP_MID_BITS) - 1);
+        mid = gArenaMap[rootIndex];
+        if(mid == NULL && arena == NULL)
+        {
+            continue;
+        }
+        if(mid == NULL)
+        {
+            mid = (arenaMapMid*)calloc(1, sizeof(arenaMapMid));
+            if(mid == NULL)
+            {
+                break;
+            }
+            arenaMapPublish();
+            gArenaMap[rootIndex] = mid;
+        }
+        leaf = mid->leaves[midIndex];
+        if(leaf == NULL && arena == NULL)
+        {
+            continue;
+        }
+        if(leaf == NULL)
+        {
+            leaf = (arenaMapLeaf*)calloc(1, sizeof(arenaMapLeaf));
+            if(leaf == NULL)
+            {
+                break;
+            }
+            arenaMapPublish();
+            mid->leaves[midIndex] = leaf;
+        }
+        leaf->arenas[span & ((1 << ARENA_MAP_LEAF_BITS) - 1)] = arena;
+    }
+    mutex_unlock(&gArenaMapLock);
+    if(span != end)
+    {
+        //Forgetting never allocates, so only recording can stop early. Undo it, the caller frees the chunk
+        arenaMapSet(chunk, (size_t)(span - start) * ARENA_CHUNK_SIZE, NULL);
+        return false;
+    }
+    return true;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file arena.h
+ * @brief File containing the interface for payload allocation arenas.
+ *
+ * This file explains the interface for the arenas used to allocate all the JSON for a single response in one block.
+ */
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** An allocation arena, redfishPayload refers to this by its struct name **/
+typedef struct _payloadArena payloadArena;
+
+/**
+ * @brief Install the arena aware allocator into jansson
+ *
+ * Once installed, JSON allocated while an arena is current on a thread comes from that arena, everything else goes to the
+ * allocation functions jansson had before, malloc/free unless the application set its own.
+ */
+void arenaInstallAllocator(void);
+
+/**
+ * @brief Create a new arena
+ *
+ * @return A new arena with a reference count of 1 or NULL if the arena allocator is not installed
+ */
+payloadArena* arenaCreate(void);
+
+/**
+ * @brief Add a reference to an arena
+ *
+ * @param arena The arena to reference, may be NULL
+ * @return The arena
+ */
+payloadArena* arenaIncRef(payloadArena* arena);
+
+/**
+ * @brief Drop a reference to an arena, freeing all of its memory once the last reference is gone
+ *
+ * @param arena The arena to release, may be NULL
+ */
+void arenaDecRef(payloadArena* arena);
+
+/**
+ * @brief Keep another arena alive for as long as this arena is alive
+ *
+ * @param arena The arena that will hold the reference
+ * @param other The arena to keep alive, may be NULL
+ * @return True on success, false on allocation failure
+ */
+bool arenaAdopt(payloadArena* arena, payloadArena* other);
+
+/**
+ * @brief Does the arena own this memory?
+ *
+ * Arena chunks are tracked in a process wide map that is read without a lock, so this is a single lookup no matter how many
+ * chunks the arena has.
+ *
+ * @param arena The arena to check, may be NULL
+ * @param ptr The memory to check
+ * @return True if ptr was allocated from the arena
+ */
+bool arenaContains(payloadArena* arena, const void* ptr);
+
+/**
+ * @brief Direct all JSON allocations made on this thread to an arena
+ *
+ * @param arena The arena to allocate from, NULL to go back to the heap
+ * @return The arena that was previously current on this thread
+ */
+payloadArena* arenaSetCurrent(payloadArena* arena);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
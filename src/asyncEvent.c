@@ -8,6 +8,7 @@
 
 #include "internal_service.h"
 #include "redfishService.h"
+#include "redfishPayload.h"
 #include "asyncEvent.h"
 #include "util.h"
 #include "debug.h"
@@ -359,6 +360,8 @@ static threadRet WINAPI eventActorTask(void* args)
     {
         freeQueue(service->eventThreadQueue);
         service->eventThreadQueue = NULL;
+        mutex_destroy(&service->pathMemoLock);
+        mutex_destroy(&service->rootCacheLock);
         free(service);
     }
 #ifdef _MSC_VER
@@ -903,7 +906,7 @@ static size_t getRedfishEventInfoFromPayload(redfishPayload* payload, enumerator
         *events = NULL;
         return 0;
     }
-    count = json_array_size(eventArray->json);
+    count = json_array_size(getPayloadJson(eventArray));
     ret = calloc(count, sizeof(EventInfo));
     if(ret == NULL)
     {
@@ -4,6 +4,7 @@
 // License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
 //----------------------------------------------------------------------------
 #include "internal_service.h"
+#include "internal_snapshot.h"
 #include <redfishRawAsync.h>
 
 #include <string.h>
@@ -25,6 +26,7 @@ static size_t curlWriteMemory(void *contents, size_t size, size_t nmemb, void *u
 static size_t curlReadMemory(void *ptr, size_t size, size_t nmemb, void *userp);
 static int curlSeekMemory(void *userp, curl_off_t offset, int origin);
 static int addHeader(httpHeader** headersPtr, const char* name, const char* value);
+static unsigned long long getMonotonicTime(void);
 
 asyncHttpRequest* createRequest(const char* url, httpMethod method, size_t bodysize, char* body)
 {
@@ -76,18 +78,28 @@ httpHeader* responseGetHeader(asyncHttpResponse* response, const char* name)
  *
  * An item representing work for the async queue. This is usually a async HTTP request, but could also be a command for the thread.
  */
-typedef struct
+typedef struct _asyncWorkItem
 {
     /** This work item instructs the thread to terminate **/
     bool term;
-    /** This is the request to process if term is false **/
+    /** This work item runs work instead of sending a request **/
+    asyncWorkCallback work;
+    /** This is the request to process if term is false and work is NULL **/
     asyncHttpRequest* request;
     /** The callback for the request **/
     asyncRawCallback callback;
     /** The context for the request **/
     void* context;
+    /** The monotonic time in microseconds before which the item is not run, 0 to run it when popped **/
+    unsigned long long due;
+    /** The next item waiting on the thread's delayed list **/
+    struct _asyncWorkItem* next;
 } asyncWorkItem;
 
+static void replayRequest(redfishService* service, asyncWorkItem* workItem);
+static void delayWorkItem(asyncWorkItem** delayed, asyncWorkItem* workItem);
+static void runDelayedWorkItem(redfishService* service, asyncWorkItem* workItem);
+
 bool startRawAsyncRequest(redfishService* service, asyncHttpRequest* request, asyncRawCallback callback, void* context)
 {
     asyncWorkItem* workItem;
@@ -107,9 +119,46 @@ bool startRawAsyncRequest(redfishService* service, asyncHttpRequest* request, as
         return false;
     }
     workItem->term = false;
+    workItem->work = NULL;
     workItem->request = request;
     workItem->callback = callback;
     workItem->context = context;
+    workItem->due = 0;
+    workItem->next = NULL;
+    queuePush(service->queue, workItem);
+    return true;
+}
+
+bool queueAsyncWork(redfishService* service, asyncWorkCallback work, void* context)
+{
+    return queueDelayedAsyncWork(service, work, context, 0);
+}
+
+bool queueDelayedAsyncWork(redfishService* service, asyncWorkCallback work, void* context, unsigned long delay)
+{
+    asyncWorkItem* workItem;
+
+    if(service == NULL || work == NULL)
+    {
+        return false;
+    }
+    if(service->queue == NULL)
+    {
+        initAsyncThread(service);
+    }
+
+    workItem = malloc(sizeof(asyncWorkItem));
+    if(workItem == NULL)
+    {
+        return false;
+    }
+    workItem->term = false;
+    workItem->work = work;
+    workItem->request = NULL;
+    workItem->callback = NULL;
+    workItem->context = context;
+    workItem->due = delay ? getMonotonicTime() + delay : 0;
+    workItem->next = NULL;
     queuePush(service->queue, workItem);
     return true;
 }
@@ -131,6 +180,9 @@ void terminateAsyncThread(redfishService* service)
         return;
     }
     workItem->term = true;
+    workItem->work = NULL;
+    workItem->due = 0;
+    workItem->next = NULL;
     queuePush(service->queue, workItem);
     if(service->asyncThread == getThreadId())
     {
@@ -232,6 +284,8 @@ threadRet rawAsyncWorkThread(void* data)
     redfishService* service = (redfishService*)data;
     queue* q = service->queue;
     asyncWorkItem* workItem = NULL;
+    asyncWorkItem* delayed = NULL;
+    unsigned long long now;
     CURL* curl;
     CURLcode res;
     asyncHttpResponse* response;
@@ -241,6 +295,7 @@ threadRet rawAsyncWorkThread(void* data)
     char headerStr[1024];
     httpHeader* current;
     char* redirect;
+    double totalTime;
     bool noReuse = false;
 
     if(curlInitDone == false)
@@ -270,12 +325,48 @@ threadRet rawAsyncWorkThread(void* data)
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readChunk);
     curl_easy_setopt(curl, CURLOPT_READDATA, &writeChunk);
 
-    while(queuePop(q, (void**)&workItem) == 0)
+    while(1)
     {
+        //Run the delayed work that is due, then wait for new work no longer than the next delayed item needs
+        now = getMonotonicTime();
+        while(delayed && delayed->due <= now)
+        {
+            workItem = delayed;
+            delayed = workItem->next;
+            runDelayedWorkItem(service, workItem);
+        }
+        workItem = NULL;
+        if(delayed)
+        {
+            if(queuePopTimeout(q, (void**)&workItem, (unsigned long)(delayed->due - now)) != 0)
+            {
+                continue;
+            }
+        }
+        else if(queuePop(q, (void**)&workItem) != 0)
+        {
+            break;
+        }
         if(workItem->term)
         {
             break;
         }
+        if(service->replay && workItem->work == NULL && workItem->due == 0 && workItem->callback &&
+           (workItem->request->method == HTTP_GET || workItem->request->method == HTTP_HEAD))
+        {
+            workItem->due = getMonotonicTime() + replaySnapshotDelay(service, workItem->request->url);
+        }
+        if(workItem->due > getMonotonicTime())
+        {
+            //Answers from a snapshot wait here for as long as the service would have taken instead of holding up the thread
+            delayWorkItem(&delayed, workItem);
+            continue;
+        }
+        if(workItem->work || service->replay)
+        {
+            runDelayedWorkItem(service, workItem);
+            continue;
+        }
         //Process workItem
         writeChunk.memory = workItem->request->body;
         writeChunk.size = workItem->request->bodySize;
@@ -292,6 +383,7 @@ threadRet rawAsyncWorkThread(void* data)
                 continue;
             }
             response->headers = NULL;
+            response->responseTime = 0;
             //If this fails then we just don't get headers returned...
             curl_easy_setopt(curl, CURLOPT_HEADERDATA, response);
             readChunk.memory = (char*)malloc(1);
@@ -400,6 +492,10 @@ threadRet rawAsyncWorkThread(void* data)
                 REDFISH_DEBUG_NOTICE_PRINT("%s: Got response for url %s with code %ld\n", __func__, workItem->request->url, response->httpResponseCode);
                 response->body = readChunk.memory;
                 response->bodySize = readChunk.size;
+                if(curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &totalTime) == CURLE_OK)
+                {
+                    response->responseTime = (unsigned long)(totalTime * 1000000.0);
+                }
             }
             //It is the callback's responsibilty to free request, response, and context...
             workItem->callback(workItem->request, response, workItem->context);
@@ -411,11 +507,25 @@ threadRet rawAsyncWorkThread(void* data)
         safeFree(workItem);
     }
     safeFree(workItem);
+    //Nothing waits for the delayed work once the thread is told to stop
+    while(delayed)
+    {
+        workItem = delayed;
+        delayed = workItem->next;
+        runDelayedWorkItem(service, workItem);
+    }
     curl_easy_cleanup(curl);
     if(service->selfTerm)
     {
+        if(service->replay)
+        {
+            cleanupSnapshot(service->replay);
+            service->replay = NULL;
+        }
         freeQueue(service->queue);
         service->queue = NULL;
+        mutex_destroy(&service->pathMemoLock);
+        mutex_destroy(&service->rootCacheLock);
         free(service);
     }
 #ifdef _MSC_VER
@@ -426,6 +536,97 @@ threadRet rawAsyncWorkThread(void* data)
 #endif
 }
 
+/*Answer a request from the service's snapshot as the service would have*/
+static void replayRequest(redfishService* service, asyncWorkItem* workItem)
+{
+    asyncHttpResponse* response;
+    redfishPayload* payload;
+
+    if(workItem->callback == NULL)
+    {
+        freeAsyncRequest(workItem->request);
+        return;
+    }
+    response = malloc(sizeof(asyncHttpResponse));
+    if(response == NULL)
+    {
+        workItem->callback(workItem->request, response, workItem->context);
+        return;
+    }
+    response->headers = NULL;
+    response->connectError = 0;
+    response->body = NULL;
+    response->bodySize = 0;
+    response->responseTime = 0;
+    if(workItem->request->method != HTTP_GET && workItem->request->method != HTTP_HEAD)
+    {
+        response->httpResponseCode = 405;
+    }
+    else
+    {
+        //Only raw requests get here, GETs made through the redfish calls are handed the stored payload without reparsing it
+        payload = replaySnapshotUri(service, workItem->request->url);
+        if(payload)
+        {
+            response->body = payloadToString(payload, false);
+            response->bodySize = response->body ? strlen(response->body) : 0;
+            response->responseTime = payload->responseTime;
+            cleanupPayload(payload);
+        }
+        response->httpResponseCode = response->body ? 200 : 404;
+    }
+    if(response->body)
+    {
+        addHeader(&(response->headers), "Content-Type", "application/json");
+        if(workItem->request->method == HTTP_HEAD)
+        {
+            free(response->body);
+            response->body = NULL;
+            response->bodySize = 0;
+        }
+    }
+    REDFISH_DEBUG_NOTICE_PRINT("%s: Replayed url %s with code %ld\n", __func__, workItem->request->url, response->httpResponseCode);
+    //It is the callback's responsibilty to free request, response, and context...
+    workItem->callback(workItem->request, response, workItem->context);
+}
+
+/*Add a work item to the delayed list, which is kept in the order the items are due*/
+static void delayWorkItem(asyncWorkItem** delayed, asyncWorkItem* workItem)
+{
+    while(*delayed && (*delayed)->due <= workItem->due)
+    {
+        delayed = &((*delayed)->next);
+    }
+    workItem->next = *delayed;
+    *delayed = workItem;
+}
+
+/*Run a work item that doesn't go out over the network and free it*/
+static void runDelayedWorkItem(redfishService* service, asyncWorkItem* workItem)
+{
+    if(workItem->work)
+    {
+        workItem->work(workItem->context);
+    }
+    else
+    {
+        replayRequest(service, workItem);
+    }
+    safeFree(workItem);
+}
+
+static unsigned long long getMonotonicTime(void)
+{
+#ifdef _MSC_VER
+    return (unsigned long long)GetTickCount64() * 1000;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long long)ts.tv_sec * 1000000) + ((unsigned long long)ts.tv_nsec / 1000);
+#endif
+}
+
 static void safeFree(void* ptr)
 {
     if(ptr)
@@ -0,0 +1,385 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+
+#include "internal_service.h"
+#include <redfishCrawl.h>
+#include "odataQuery.h"
+
+#include "debug.h"
+#include "util.h"
+
+/** A resource waiting to be requested **/
+typedef struct
+{
+    /** The URI of the resource **/
+    char* uri;
+    /** The number of links followed to find it **/
+    unsigned int depth;
+} crawlLink;
+
+/** Internal structure used for a crawl **/
+typedef struct
+{
+    /** The service being crawled, a reference is held until the crawl is done **/
+    redfishService* service;
+    /** The callback for each resource **/
+    redfishCrawlCallback callback;
+    /** The original context for the callback **/
+    void* originalContext;
+    /** A copy of the options for each resource request, including its strings **/
+    redfishAsyncOptions options;
+    /** The most links to follow, 0 means no limit **/
+    unsigned int maxDepth;
+    /** NULL terminated list of property names not to follow **/
+    char** skip;
+    /** Every URI queued so far, used as a set **/
+    json_t* seen;
+    /** The resources waiting to be requested **/
+    crawlLink* pending;
+    /** The first entry of pending still waiting **/
+    size_t pendingHead;
+    /** The number of entries used in pending **/
+    size_t pendingCount;
+    /** The number of entries allocated in pending **/
+    size_t pendingSize;
+    /** The number of resource requests outstanding **/
+    size_t inFlight;
+    /** The most resource requests to have outstanding at once **/
+    size_t window;
+    /** Set while a thread is starting requests, that thread also finishes the crawl **/
+    bool starting;
+    /** Set if any resource could not be obtained **/
+    bool failed;
+    /** Resources can arrive on the async thread while others are still being requested **/
+    mutex lock;
+} crawlContext;
+
+/** The context for a single resource request **/
+typedef struct
+{
+    /** The overall context **/
+    crawlContext* parent;
+    /** The resource being requested **/
+    crawlLink link;
+} crawlFetch;
+
+static void crawlStart(crawlContext* myContext);
+static void crawlGotResource(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static bool crawlQueue(crawlContext* myContext, const char* uri, unsigned int depth);
+static void crawlAddLinks(crawlContext* myContext, json_t* json, unsigned int depth);
+static bool crawlSkipped(crawlContext* myContext, const char* name);
+static void crawlFree(crawlContext* myContext);
+
+bool crawlServiceAsync(redfishService* service, redfishCrawlOptions* options, redfishCrawlCallback callback, void* context)
+{
+    crawlContext* myContext;
+    crawlFetch* fetch;
+    const char* root = NULL;
+    size_t count = 0;
+    size_t i;
+
+    if(service == NULL || callback == NULL)
+    {
+        return false;
+    }
+    myContext = (crawlContext*)calloc(1, sizeof(crawlContext));
+    if(myContext == NULL)
+    {
+        return false;
+    }
+    myContext->service = service;
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->window = REDFISH_DEFAULT_MAX_IN_FLIGHT;
+    myContext->seen = json_object();
+    if(options)
+    {
+        root = options->rootUri;
+        myContext->maxDepth = options->maxDepth;
+        if(options->maxInFlight)
+        {
+            myContext->window = options->maxInFlight;
+        }
+        if(options->options && odataQueryCopyOptions(&myContext->options, options->options) == false)
+        {
+            crawlFree(myContext);
+            return false;
+        }
+        if(options->skipProperties)
+        {
+            while(options->skipProperties[count])
+            {
+                count++;
+            }
+        }
+    }
+    if(myContext->options.accept == 0)
+    {
+        myContext->options.accept = REDFISH_ACCEPT_JSON;
+    }
+    if(root == NULL)
+    {
+        root = json_string_value(json_object_get(service->versions, "v1"));
+    }
+    myContext->skip = (char**)calloc(count + 1, sizeof(char*));
+    if(myContext->seen == NULL || myContext->skip == NULL || root == NULL)
+    {
+        crawlFree(myContext);
+        return false;
+    }
+    for(i = 0; i < count; i++)
+    {
+        myContext->skip[i] = safeStrdup(options->skipProperties[i]);
+    }
+    mutex_init(&myContext->lock);
+    if(crawlQueue(myContext, root, 0) == false)
+    {
+        mutex_destroy(&myContext->lock);
+        crawlFree(myContext);
+        return false;
+    }
+    //Request the starting resource here so a crawl that can't start is only reported by the return value
+    fetch = (crawlFetch*)malloc(sizeof(crawlFetch));
+    if(fetch == NULL)
+    {
+        mutex_destroy(&myContext->lock);
+        crawlFree(myContext);
+        return false;
+    }
+    fetch->parent = myContext;
+    fetch->link = myContext->pending[myContext->pendingHead++];
+    myContext->inFlight = 1;
+    serviceIncRef(service);
+    if(getUriFromServiceAsync(service, fetch->link.uri, &myContext->options, crawlGotResource, fetch) == false)
+    {
+        REDFISH_DEBUG_WARNING_PRINT("%s: Unable to request %s\n", __func__, fetch->link.uri);
+        free(fetch->link.uri);
+        free(fetch);
+        mutex_destroy(&myContext->lock);
+        crawlFree(myContext);
+        serviceDecRef(service);
+        return false;
+    }
+    return true;
+}
+
+/*Called with the lock held and starting set from the async thread, releases the lock and finishes the crawl once there is nothing left to read*/
+static void crawlStart(crawlContext* myContext)
+{
+    crawlFetch* fetch;
+    redfishService* service;
+    redfishCrawlCallback callback;
+    void* originalContext;
+    bool success;
+    bool ret;
+
+    while(myContext->inFlight < myContext->window && myContext->pendingHead < myContext->pendingCount)
+    {
+        fetch = (crawlFetch*)malloc(sizeof(crawlFetch));
+        if(fetch == NULL)
+        {
+            //Try again when a request completes
+            if(myContext->inFlight)
+            {
+                break;
+            }
+            free(myContext->pending[myContext->pendingHead++].uri);
+            myContext->failed = true;
+            continue;
+        }
+        fetch->parent = myContext;
+        fetch->link = myContext->pending[myContext->pendingHead++];
+        myContext->inFlight++;
+        mutex_unlock(&myContext->lock);
+        ret = getUriFromServiceAsync(myContext->service, fetch->link.uri, &myContext->options, crawlGotResource, fetch);
+        if(ret == false)
+        {
+            REDFISH_DEBUG_WARNING_PRINT("%s: Unable to request %s\n", __func__, fetch->link.uri);
+            myContext->callback(false, 0xFFFF, NULL, fetch->link.uri, fetch->link.depth, myContext->originalContext);
+            free(fetch->link.uri);
+            free(fetch);
+        }
+        mutex_lock(&myContext->lock);
+        if(ret == false)
+        {
+            myContext->inFlight--;
+            myContext->failed = true;
+        }
+    }
+    if(myContext->pendingHead == myContext->pendingCount)
+    {
+        myContext->pendingHead = 0;
+        myContext->pendingCount = 0;
+    }
+    myContext->starting = false;
+    if(myContext->inFlight != 0 || myContext->pendingCount != 0)
+    {
+        mutex_unlock(&myContext->lock);
+        return;
+    }
+    mutex_unlock(&myContext->lock);
+    service = myContext->service;
+    callback = myContext->callback;
+    originalContext = myContext->originalContext;
+    success = !myContext->failed;
+    mutex_destroy(&myContext->lock);
+    crawlFree(myContext);
+    serviceDecRef(service);
+    callback(success, 200, NULL, NULL, REDFISH_CRAWL_END, originalContext);
+}
+
+static void crawlGotResource(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    crawlFetch* fetch = (crawlFetch*)context;
+    crawlContext* myContext = fetch->parent;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    mutex_lock(&myContext->lock);
+    if(success == false || httpCode >= 300 || payload == NULL)
+    {
+        myContext->failed = true;
+    }
+    else if(myContext->maxDepth == 0 || fetch->link.depth < myContext->maxDepth)
+    {
+        crawlAddLinks(myContext, getPayloadJson(payload), fetch->link.depth + 1);
+    }
+    mutex_unlock(&myContext->lock);
+    //Report before the request is counted as done so the final call is always the last
+    myContext->callback(success, httpCode, payload, fetch->link.uri, fetch->link.depth, myContext->originalContext);
+    free(fetch->link.uri);
+    free(fetch);
+    mutex_lock(&myContext->lock);
+    myContext->inFlight--;
+    if(myContext->starting)
+    {
+        //The thread already starting requests will fill the free slot and finish the crawl
+        mutex_unlock(&myContext->lock);
+        return;
+    }
+    myContext->starting = true;
+    crawlStart(myContext);
+}
+
+static bool crawlQueue(crawlContext* myContext, const char* uri, unsigned int depth)
+{
+    crawlLink* tmp;
+    char* key;
+    size_t length;
+
+    if(uri[0] != '/')
+    {
+        //Not on this service
+        return false;
+    }
+    //Links into a resource (i.e. /redfish/v1/Chassis/1#/Power) name the same resource
+    length = strcspn(uri, "#");
+    while(length > 1 && uri[length-1] == '/')
+    {
+        length--;
+    }
+    key = (char*)malloc(length + 1);
+    if(key == NULL)
+    {
+        return false;
+    }
+    memcpy(key, uri, length);
+    key[length] = 0;
+    if(json_object_get(myContext->seen, key) != NULL)
+    {
+        free(key);
+        return false;
+    }
+    if(myContext->pendingCount == myContext->pendingSize)
+    {
+        tmp = (crawlLink*)realloc(myContext->pending, (myContext->pendingSize ? myContext->pendingSize * 2 : 64) * sizeof(crawlLink));
+        if(tmp == NULL)
+        {
+            free(key);
+            return false;
+        }
+        myContext->pending = tmp;
+        myContext->pendingSize = myContext->pendingSize ? myContext->pendingSize * 2 : 64;
+    }
+    json_object_set_new(myContext->seen, key, json_true());
+    myContext->pending[myContext->pendingCount].uri = key;
+    myContext->pending[myContext->pendingCount].depth = depth;
+    myContext->pendingCount++;
+    return true;
+}
+
+static void crawlAddLinks(crawlContext* myContext, json_t* json, unsigned int depth)
+{
+    const char* key;
+    json_t* value;
+    size_t index;
+
+    if(json_is_array(json))
+    {
+        json_array_foreach(json, index, value)
+        {
+            crawlAddLinks(myContext, value, depth);
+        }
+        return;
+    }
+    if(!json_is_object(json))
+    {
+        return;
+    }
+    json_object_foreach(json, key, value)
+    {
+        if(strcmp(key, "@odata.id") == 0)
+        {
+            if(json_is_string(value))
+            {
+                crawlQueue(myContext, json_string_value(value), depth);
+            }
+        }
+        else if(crawlSkipped(myContext, key) == false)
+        {
+            crawlAddLinks(myContext, value, depth);
+        }
+    }
+}
+
+static bool crawlSkipped(crawlContext* myContext, const char* name)
+{
+    size_t i;
+
+    for(i = 0; myContext->skip[i]; i++)
+    {
+        if(strcmp(myContext->skip[i], name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void crawlFree(crawlContext* myContext)
+{
+    size_t i;
+
+    for(i = myContext->pendingHead; i < myContext->pendingCount; i++)
+    {
+        free(myContext->pending[i].uri);
+    }
+    if(myContext->skip)
+    {
+        for(i = 0; myContext->skip[i]; i++)
+        {
+            free(myContext->skip[i]);
+        }
+    }
+    free(myContext->skip);
+    free(myContext->pending);
+    odataQueryFreeOptions(&myContext->options);
+    json_decref(myContext->seen);
+    free(myContext);
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
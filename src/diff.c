@@ -0,0 +1,404 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <redfishDiff.h>
+#include "internal_snapshot.h"
+#include "tape.h"
+#include "debug.h"
+#include "util.h"
+
+/** Internal structure used while comparing two resources **/
+typedef struct
+{
+    /** The callback for each difference **/
+    redfishDiffCallback callback;
+    /** The original context for the callback **/
+    void* originalContext;
+    /** The URI of the resources being compared **/
+    const char* uri;
+    /** The older resource **/
+    payloadTape* before;
+    /** The newer resource **/
+    payloadTape* after;
+    /** The JSON pointer to the values being compared **/
+    char* pointer;
+    /** The length of pointer **/
+    size_t length;
+    /** The number of bytes allocated for pointer **/
+    size_t size;
+    /** Set once the callback asks to stop or anything fails **/
+    bool stopped;
+} diffState;
+
+static void diffNodes(diffState* state, size_t beforeNode, size_t afterNode);
+static void diffObjects(diffState* state, size_t beforeNode, size_t afterNode);
+static void diffArrays(diffState* state, size_t beforeNode, size_t afterNode);
+static bool diffLeavesEqual(diffState* state, size_t beforeNode, size_t afterNode);
+static bool diffFindMember(payloadTape* tape, size_t node, size_t index, const char* key, size_t* child);
+static void diffReport(diffState* state, redfishDiffType type, size_t beforeNode, size_t afterNode);
+static size_t diffPushKey(diffState* state, const char* key);
+static size_t diffPushIndex(diffState* state, size_t index);
+static void diffPop(diffState* state, size_t length);
+static bool getPayloadTape(redfishPayload* payload, payloadTape** tape, size_t* node);
+
+bool diffPayloads(redfishPayload* before, redfishPayload* after, const char* uri, redfishDiffCallback callback, void* context)
+{
+    diffState state;
+    size_t beforeNode;
+    size_t afterNode;
+
+    if(callback == NULL)
+    {
+        return false;
+    }
+    memset(&state, 0, sizeof(state));
+    state.callback = callback;
+    state.originalContext = context;
+    state.uri = uri;
+    if(getPayloadTape(before, &state.before, &beforeNode) == false)
+    {
+        return false;
+    }
+    if(getPayloadTape(after, &state.after, &afterNode) == false)
+    {
+        tapeDecRef(state.before);
+        return false;
+    }
+    diffNodes(&state, beforeNode, afterNode);
+    tapeDecRef(state.before);
+    tapeDecRef(state.after);
+    free(state.pointer);
+    return !state.stopped;
+}
+
+bool diffSnapshots(redfishSnapshot* before, redfishSnapshot* after, redfishDiffCallback callback, void* context)
+{
+    diffState state;
+    size_t beforeCount = getSnapshotCount(before);
+    size_t afterCount = getSnapshotCount(after);
+    size_t i = 0;
+    size_t j = 0;
+    int cmp;
+
+    if(before == NULL || after == NULL || callback == NULL)
+    {
+        return false;
+    }
+    memset(&state, 0, sizeof(state));
+    state.callback = callback;
+    state.originalContext = context;
+    //Both indexes are sorted by URI, so walk them together
+    while((i < beforeCount || j < afterCount) && state.stopped == false)
+    {
+        if(i == beforeCount)
+        {
+            cmp = 1;
+        }
+        else if(j == afterCount)
+        {
+            cmp = -1;
+        }
+        else
+        {
+            cmp = strcmp(getSnapshotUri(before, i), getSnapshotUri(after, j));
+        }
+        if(cmp == 0 && getSnapshotHash(before, i) == getSnapshotHash(after, j))
+        {
+            //Unchanged, the resource is never read
+            i++;
+            j++;
+            continue;
+        }
+        state.before = (cmp <= 0) ? getSnapshotTape(before, i) : NULL;
+        state.after = (cmp >= 0) ? getSnapshotTape(after, j) : NULL;
+        state.uri = (cmp <= 0) ? getSnapshotUri(before, i) : getSnapshotUri(after, j);
+        if((cmp <= 0 && state.before == NULL) || (cmp >= 0 && state.after == NULL))
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to read %s\n", __func__, state.uri);
+            state.stopped = true;
+        }
+        else if(cmp == 0)
+        {
+            diffNodes(&state, tapeRoot(state.before), tapeRoot(state.after));
+        }
+        else if(cmp < 0)
+        {
+            diffReport(&state, REDFISH_DIFF_REMOVED, tapeRoot(state.before), 0);
+        }
+        else
+        {
+            diffReport(&state, REDFISH_DIFF_ADDED, 0, tapeRoot(state.after));
+        }
+        tapeDecRef(state.before);
+        tapeDecRef(state.after);
+        if(cmp <= 0)
+        {
+            i++;
+        }
+        if(cmp >= 0)
+        {
+            j++;
+        }
+    }
+    free(state.pointer);
+    return !state.stopped;
+}
+
+static void diffNodes(diffState* state, size_t beforeNode, size_t afterNode)
+{
+    json_type type = tapeType(state->before, beforeNode);
+
+    if(state->stopped)
+    {
+        return;
+    }
+    if(type != tapeType(state->after, afterNode))
+    {
+        diffReport(state, REDFISH_DIFF_CHANGED, beforeNode, afterNode);
+    }
+    else if(type == JSON_OBJECT)
+    {
+        diffObjects(state, beforeNode, afterNode);
+    }
+    else if(type == JSON_ARRAY)
+    {
+        diffArrays(state, beforeNode, afterNode);
+    }
+    else if(diffLeavesEqual(state, beforeNode, afterNode) == false)
+    {
+        diffReport(state, REDFISH_DIFF_CHANGED, beforeNode, afterNode);
+    }
+}
+
+static void diffObjects(diffState* state, size_t beforeNode, size_t afterNode)
+{
+    size_t beforeCount = tapeSize(state->before, beforeNode);
+    size_t afterCount = tapeSize(state->after, afterNode);
+    const char* key;
+    size_t beforeChild;
+    size_t afterChild;
+    size_t length;
+    size_t i;
+
+    for(i = 0; i < beforeCount && state->stopped == false; i++)
+    {
+        tapeGetByIndex(state->before, beforeNode, i, &key, &beforeChild);
+        length = diffPushKey(state, key);
+        if(diffFindMember(state->after, afterNode, i, key, &afterChild))
+        {
+            diffNodes(state, beforeChild, afterChild);
+        }
+        else
+        {
+            diffReport(state, REDFISH_DIFF_REMOVED, beforeChild, 0);
+        }
+        diffPop(state, length);
+    }
+    for(i = 0; i < afterCount && state->stopped == false; i++)
+    {
+        tapeGetByIndex(state->after, afterNode, i, &key, &afterChild);
+        if(diffFindMember(state->before, beforeNode, i, key, &beforeChild) == false)
+        {
+            length = diffPushKey(state, key);
+            diffReport(state, REDFISH_DIFF_ADDED, 0, afterChild);
+            diffPop(state, length);
+        }
+    }
+}
+
+static void diffArrays(diffState* state, size_t beforeNode, size_t afterNode)
+{
+    size_t beforeCount = tapeSize(state->before, beforeNode);
+    size_t afterCount = tapeSize(state->after, afterNode);
+    size_t beforeChild = 0;
+    size_t afterChild = 0;
+    size_t length;
+    size_t i;
+
+    for(i = 0; (i < beforeCount || i < afterCount) && state->stopped == false; i++)
+    {
+        length = diffPushIndex(state, i);
+        if(i < beforeCount)
+        {
+            tapeGetByIndex(state->before, beforeNode, i, NULL, &beforeChild);
+        }
+        if(i < afterCount)
+        {
+            tapeGetByIndex(state->after, afterNode, i, NULL, &afterChild);
+        }
+        if(i >= afterCount)
+        {
+            diffReport(state, REDFISH_DIFF_REMOVED, beforeChild, 0);
+        }
+        else if(i >= beforeCount)
+        {
+            diffReport(state, REDFISH_DIFF_ADDED, 0, afterChild);
+        }
+        else
+        {
+            diffNodes(state, beforeChild, afterChild);
+        }
+        diffPop(state, length);
+    }
+}
+
+static bool diffLeavesEqual(diffState* state, size_t beforeNode, size_t afterNode)
+{
+    const char* beforeString;
+    const char* afterString;
+    size_t beforeLength;
+    size_t afterLength;
+
+    switch(tapeType(state->before, beforeNode))
+    {
+        case JSON_STRING:
+            beforeString = tapeStringValue(state->before, beforeNode, &beforeLength);
+            afterString = tapeStringValue(state->after, afterNode, &afterLength);
+            return (beforeLength == afterLength && memcmp(beforeString, afterString, beforeLength) == 0);
+        case JSON_INTEGER:
+            return (tapeIntegerValue(state->before, beforeNode) == tapeIntegerValue(state->after, afterNode));
+        case JSON_REAL:
+            return (tapeRealValue(state->before, beforeNode) == tapeRealValue(state->after, afterNode));
+        default:
+            //true, false and null carry no value past their type
+            return true;
+    }
+}
+
+/*Members are usually in the same order in both versions, so try the same position before searching*/
+static bool diffFindMember(payloadTape* tape, size_t node, size_t index, const char* key, size_t* child)
+{
+    const char* otherKey;
+
+    if(tapeGetByIndex(tape, node, index, &otherKey, child) && strcmp(key, otherKey) == 0)
+    {
+        return true;
+    }
+    return tapeObjectGet(tape, node, key, strlen(key), child);
+}
+
+static void diffReport(diffState* state, redfishDiffType type, size_t beforeNode, size_t afterNode)
+{
+    json_t* before = NULL;
+    json_t* after = NULL;
+
+    if(state->stopped)
+    {
+        return;
+    }
+    if(type != REDFISH_DIFF_ADDED)
+    {
+        before = tapeToJson(state->before, beforeNode);
+    }
+    if(type != REDFISH_DIFF_REMOVED)
+    {
+        after = tapeToJson(state->after, afterNode);
+    }
+    if((type != REDFISH_DIFF_ADDED && before == NULL) || (type != REDFISH_DIFF_REMOVED && after == NULL))
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to convert values\n", __func__);
+        state->stopped = true;
+    }
+    else if(state->callback(type, state->uri, state->pointer ? state->pointer : "", before, after, state->originalContext) == false)
+    {
+        state->stopped = true;
+    }
+    json_decref(before);
+    json_decref(after);
+}
+
+/*Append "/key" to the pointer, escaping it as RFC 6901 requires, and return the length to restore afterwards*/
+static size_t diffPushKey(diffState* state, const char* key)
+{
+    size_t length = state->length;
+    size_t needed = length + 1 + (2 * strlen(key)) + 1;
+    char* tmp;
+    char* out;
+
+    if(needed > state->size)
+    {
+        tmp = (char*)realloc(state->pointer, needed * 2);
+        if(tmp == NULL)
+        {
+            state->stopped = true;
+            return length;
+        }
+        state->pointer = tmp;
+        state->size = needed * 2;
+    }
+    out = state->pointer + length;
+    *out++ = '/';
+    for(; *key; key++)
+    {
+        if(*key == '~')
+        {
+            *out++ = '~';
+            *out++ = '0';
+        }
+        else if(*key == '/')
+        {
+            *out++ = '~';
+            *out++ = '1';
+        }
+        else
+        {
+            *out++ = *key;
+        }
+    }
+    *out = 0;
+    state->length = (size_t)(out - state->pointer);
+    return length;
+}
+
+static size_t diffPushIndex(diffState* state, size_t index)
+{
+    char buffer[32];
+
+    snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)index);
+    return diffPushKey(state, buffer);
+}
+
+static void diffPop(diffState* state, size_t length)
+{
+    state->length = length;
+    if(state->pointer)
+    {
+        state->pointer[length] = 0;
+    }
+}
+
+/*Frozen payloads are compared in place, anything else is frozen into a temporary tape*/
+static bool getPayloadTape(redfishPayload* payload, payloadTape** tape, size_t* node)
+{
+    json_t* json;
+
+    if(payload == NULL || payload->contentType != PAYLOAD_CONTENT_JSON)
+    {
+        return false;
+    }
+    if(payload->json == NULL && payload->tape != NULL)
+    {
+        *tape = tapeIncRef(payload->tape);
+        *node = payload->tapeNode;
+        return true;
+    }
+    json = getPayloadJson(payload);
+    if(json == NULL)
+    {
+        return false;
+    }
+    *tape = tapeCreateFromJson(json);
+    if(*tape == NULL)
+    {
+        return false;
+    }
+    *node = tapeRoot(*tape);
+    return true;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+
+#include "hash.h"
+
+/** The FNV-1a 64 bit offset basis **/
+#define HASH_BASIS 0xcbf29ce484222325ULL
+/** The FNV-1a 64 bit prime **/
+#define HASH_PRIME 0x100000001b3ULL
+
+static uint64_t hashMix(uint64_t value);
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t length);
+
+uint64_t hashSeed(json_type type)
+{
+    return hashMix((uint64_t)type + 1);
+}
+
+uint64_t hashString(const char* value, size_t length)
+{
+    return hashMix(hashBytes(hashSeed(JSON_STRING), value, length));
+}
+
+uint64_t hashInteger(int64_t value)
+{
+    return hashMix(hashSeed(JSON_INTEGER) ^ (uint64_t)value);
+}
+
+uint64_t hashReal(double value)
+{
+    uint64_t bits;
+
+    if(value == 0.0)
+    {
+        //-0.0 == 0.0
+        value = 0.0;
+    }
+    memcpy(&bits, &value, sizeof(bits));
+    return hashMix(hashSeed(JSON_REAL) ^ bits);
+}
+
+uint64_t hashMember(const char* key, size_t keyLength, uint64_t valueHash)
+{
+    return hashMix(hashBytes(HASH_BASIS, key, keyLength) ^ hashMix(valueHash));
+}
+
+uint64_t hashObject(uint64_t memberSum, size_t count)
+{
+    return hashMix(hashSeed(JSON_OBJECT) ^ memberSum ^ (uint64_t)count);
+}
+
+uint64_t hashArrayStart(size_t count)
+{
+    return hashSeed(JSON_ARRAY) ^ (uint64_t)count;
+}
+
+uint64_t hashArrayElement(uint64_t hash, uint64_t elementHash)
+{
+    return hashMix(hash ^ elementHash);
+}
+
+bool hashIgnored(const char* key, const char** ignore)
+{
+    size_t i;
+
+    if(ignore == NULL)
+    {
+        return false;
+    }
+    for(i = 0; ignore[i]; i++)
+    {
+        if(strcmp(ignore[i], key) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t jsonHash(json_t* json, const char** ignore)
+{
+    const char* key;
+    json_t* value;
+    uint64_t hash = 0;
+    size_t count = 0;
+    size_t index;
+
+    switch(json_typeof(json))
+    {
+        case JSON_OBJECT:
+            json_object_foreach(json, key, value)
+            {
+                if(hashIgnored(key, ignore) == false)
+                {
+                    hash += hashMember(key, strlen(key), jsonHash(value, ignore));
+                    count++;
+                }
+            }
+            return hashObject(hash, count);
+        case JSON_ARRAY:
+            hash = hashArrayStart(json_array_size(json));
+            json_array_foreach(json, index, value)
+            {
+                hash = hashArrayElement(hash, jsonHash(value, ignore));
+            }
+            return hash;
+        case JSON_STRING:
+            return hashString(json_string_value(json), json_string_length(json));
+        case JSON_INTEGER:
+            return hashInteger((int64_t)json_integer_value(json));
+        case JSON_REAL:
+            return hashReal(json_real_value(json));
+        default:
+            return hashSeed(json_typeof(json));
+    }
+}
+
+/*The splitmix64 finalizer, spreads every input bit over the whole result*/
+static uint64_t hashMix(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t length)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t i;
+
+    for(i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= HASH_PRIME;
+    }
+    return hash;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
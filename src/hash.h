@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file hash.h
+ * @brief File containing the interface for JSON content hashes.
+ *
+ * This file explains the interface for the 64 bit content hash of a JSON value. The hash is built from the pieces below so
+ * every representation of a payload (jansson tree or tape) gives the same result for the same content. Object members are
+ * combined by addition so their order does not matter, and nothing depends on the byte order of the machine.
+ */
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <jansson.h>
+
+/**
+ * @brief Get the hash of a value with no content besides its type, i.e. true, false, or null
+ *
+ * @param type The type of the value
+ * @return The hash
+ */
+uint64_t hashSeed(json_type type);
+
+/**
+ * @brief Get the hash of a string value
+ *
+ * @param value The string
+ * @param length The length of the string
+ * @return The hash
+ */
+uint64_t hashString(const char* value, size_t length);
+
+/**
+ * @brief Get the hash of an integer value
+ *
+ * @param value The integer
+ * @return The hash
+ */
+uint64_t hashInteger(int64_t value);
+
+/**
+ * @brief Get the hash of a real value
+ *
+ * @param value The real
+ * @return The hash
+ */
+uint64_t hashReal(double value);
+
+/**
+ * @brief Get the hash of an object member, to be summed into the object's hash
+ *
+ * @param key The member name
+ * @param keyLength The length of the member name
+ * @param valueHash The hash of the member's value
+ * @return The hash
+ */
+uint64_t hashMember(const char* key, size_t keyLength, uint64_t valueHash);
+
+/**
+ * @brief Get the hash of an object
+ *
+ * @param memberSum The sum of hashMember() for every member
+ * @param count The number of members
+ * @return The hash
+ */
+uint64_t hashObject(uint64_t memberSum, size_t count);
+
+/**
+ * @brief Start the hash of an array
+ *
+ * @param count The number of elements
+ * @return The hash of an empty array, to be passed to hashArrayElement() for each element in order
+ */
+uint64_t hashArrayStart(size_t count);
+
+/**
+ * @brief Add an element to the hash of an array
+ *
+ * @param hash The hash so far
+ * @param elementHash The hash of the element
+ * @return The new hash
+ */
+uint64_t hashArrayElement(uint64_t hash, uint64_t elementHash);
+
+/**
+ * @brief Check if an object member is left out of hashes
+ *
+ * @param key The member name
+ * @param ignore NULL terminated list of member names to leave out, may be NULL
+ * @return True if the member is in the list
+ */
+bool hashIgnored(const char* key, const char** ignore);
+
+/**
+ * @brief Get the hash of a jansson value
+ *
+ * @param json The value to hash, along with everything under it
+ * @param ignore NULL terminated list of member names to leave out at any depth, may be NULL
+ * @return The hash
+ */
+uint64_t jsonHash(json_t* json, const char** ignore);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+
+#include "intern.h"
+#include "arena.h"
+#include "queue.h"
+#include "debug.h"
+
+/** The longest string value that will be interned **/
+#define INTERN_MAX_LENGTH  64
+/** The most values the table will hold, after this values are only looked up **/
+#define INTERN_MAX_ENTRIES 4096
+
+static bool isInternCandidate(const char* str, size_t length);
+static json_t* getInternedValue(json_t* value);
+static void internWalk(json_t* json);
+
+static bool gInternEnabled = false;
+static bool gInternInitialized = false;
+static mutex gInternLock;
+/** Maps the string to the shared immortal json_t for it **/
+static json_t* gInternTable = NULL;
+
+void internSetEnabled(bool enable)
+{
+    if(enable && gInternInitialized == false)
+    {
+        mutex_init(&gInternLock);
+        gInternInitialized = true;
+    }
+    gInternEnabled = enable;
+}
+
+bool internIsEnabled(void)
+{
+    return gInternEnabled;
+}
+
+void internJsonValues(json_t* json)
+{
+    if(gInternEnabled == false || json == NULL)
+    {
+        return;
+    }
+    //The tree belongs to the caller, the lock is only needed around the table itself
+    internWalk(json);
+}
+
+static bool isInternCandidate(const char* str, size_t length)
+{
+    size_t i;
+
+    if(length == 0 || length > INTERN_MAX_LENGTH)
+    {
+        return false;
+    }
+    //Enum values, ids, and odata types. Anything with spaces or slashes is probably unique (names, URIs, descriptions)
+    for(i = 0; i < length; i++)
+    {
+        if(!((str[i] >= 'A' && str[i] <= 'Z') || (str[i] >= 'a' && str[i] <= 'z') || (str[i] >= '0' && str[i] <= '9') ||
+             str[i] == '_' || str[i] == '.' || str[i] == '#' || str[i] == '-'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static json_t* getInternedValue(json_t* value)
+{
+    const char* str = json_string_value(value);
+    size_t length = json_string_length(value);
+    json_t* ret;
+    payloadArena* previousArena;
+
+    if(!isInternCandidate(str, length))
+    {
+        return NULL;
+    }
+    mutex_lock(&gInternLock);
+    //The table lives forever, so keep it out of any arena
+    previousArena = arenaSetCurrent(NULL);
+    if(gInternTable == NULL)
+    {
+        gInternTable = json_object();
+    }
+    ret = json_object_get(gInternTable, str);
+    if(ret != NULL || gInternTable == NULL || json_object_size(gInternTable) >= INTERN_MAX_ENTRIES)
+    {
+        arenaSetCurrent(previousArena);
+        mutex_unlock(&gInternLock);
+        return ret;
+    }
+    ret = json_stringn(str, length);
+    if(ret != NULL)
+    {
+        //Make the value immortal, jansson skips reference counting for these just like json_true() and friends
+        ret->refcount = (size_t)-1;
+        if(json_object_set_new(gInternTable, str, ret) != 0)
+        {
+            REDFISH_DEBUG_WARNING_PRINT("%s: Unable to add %s to the intern table\n", __func__, str);
+            ret = NULL;
+        }
+    }
+    arenaSetCurrent(previousArena);
+    mutex_unlock(&gInternLock);
+    return ret;
+}
+
+static void internWalk(json_t* json)
+{
+    const char* key;
+    json_t* value;
+    json_t* interned;
+    size_t i;
+
+    switch(json_typeof(json))
+    {
+        case JSON_OBJECT:
+            json_object_foreach(json, key, value)
+            {
+                if(json_is_string(value))
+                {
+                    interned = getInternedValue(value);
+                    if(interned != NULL && interned != value)
+                    {
+                        json_object_set(json, key, interned);
+                    }
+                }
+                else
+                {
+                    internWalk(value);
+                }
+            }
+            break;
+        case JSON_ARRAY:
+            json_array_foreach(json, i, value)
+            {
+                if(json_is_string(value))
+                {
+                    interned = getInternedValue(value);
+                    if(interned != NULL && interned != value)
+                    {
+                        json_array_set(json, i, interned);
+                    }
+                }
+                else
+                {
+                    internWalk(value);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,45 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file intern.h
+ * @brief File containing the interface for the string value intern table.
+ *
+ * This file explains the interface for sharing common JSON string values between payloads.
+ */
+#ifndef _INTERN_H_
+#define _INTERN_H_
+
+#include <stdbool.h>
+#include <jansson.h>
+
+/**
+ * @brief Turn interning of parsed string values on or off
+ *
+ * @param enable True to intern values from now on, false to stop
+ */
+void internSetEnabled(bool enable);
+
+/**
+ * @brief Is interning turned on?
+ *
+ * @return True if parsed payloads should be interned
+ */
+bool internIsEnabled(void);
+
+/**
+ * @brief Replace enum like string values in a JSON tree with shared immutable copies
+ *
+ * Walk the tree and swap any short identifier style string value (i.e. "OK", "Enabled", "#Chassis.v1_0_0.Chassis") for the
+ * process wide copy of that string, adding it to the table if there is room. The shared values must never be changed, so only
+ * use this on trees the library treats as read only, such as ones parsed into an arena.
+ *
+ * @param json The tree to walk
+ */
+void internJsonValues(json_t* json);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file internal_payload.h
+ * @brief File containing the interface for internal payload helpers.
+ *
+ * This file explains the interface for payload functions shared between the library sources but not exported.
+ */
+#ifndef _INT_PAYLOAD_H_
+#define _INT_PAYLOAD_H_
+
+#include <redfishPayload.h>
+#include "internal_redpath.h"
+
+/**
+ * @brief Create a redfish payload whose JSON parsing is deferred
+ *
+ * Create a new redfish payload that holds the raw JSON text and only parses it on the first call to getPayloadJson.
+ *
+ * @param content The raw JSON text. The payload takes ownership of this buffer, which must have been allocated with malloc.
+ * @param contentLength The length of the content buffer
+ * @param service The redfish service for this payload
+ * @return A new redfish payload structure or NULL on failure, in which case content has been freed
+ * @see getPayloadJson
+ */
+redfishPayload* createDeferredRedfishPayload(char* content, size_t contentLength, redfishService* service);
+
+/**
+ * @brief Create a frozen redfish payload from a tape
+ *
+ * @param tape The tape, the payload takes over the caller's reference to it
+ * @param service The redfish service for this payload, may be NULL
+ * @return A new redfish payload structure or NULL on failure, in which case the tape reference has been dropped
+ * @see freezePayload
+ */
+redfishPayload* createFrozenRedfishPayload(struct _payloadTape* tape, redfishService* service);
+
+/**
+ * @brief Get the link to the next page of a collection
+ *
+ * This does not parse the whole payload if it has not been parsed already.
+ *
+ * @param payload The collection page
+ * @return A new string containing the Members@odata.nextLink URI or NULL if this is the last page
+ */
+char* getPayloadNextLink(redfishPayload* payload);
+
+/**
+ * @brief Add the members of the next page of a collection to a collection
+ *
+ * The collection's Members@odata.nextLink is replaced by the page's, or removed once maxMembers is reached.
+ *
+ * @param collection The collection to add to
+ * @param page The next page of the collection, may be NULL to only apply maxMembers
+ * @param maxMembers The most members the collection may hold, 0 for no limit
+ * @return false if the collection could not be updated
+ */
+bool appendCollectionPage(redfishPayload* collection, redfishPayload* page, size_t maxMembers);
+
+/**
+ * @brief Evaluate a single RedPath node asynchronously
+ *
+ * Only this node is evaluated, its next pointer is ignored.
+ *
+ * @param payload The payload to evaluate the node against
+ * @param redpath The node
+ * @param options The options for each request, must stay valid until the callback
+ * @param callback The function to call with the result
+ * @param context An opaque data pointer to pass to the callback function
+ * @return false if the request could not be started, in which case the callback will not be called
+ */
+bool getPayloadForNodeAsync(redfishPayload* payload, redPathNode* redpath, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+
+/**
+ * @brief Follow part of a RedPath plan asynchronously
+ *
+ * Unlike getPayloadForPathAsync() the nodes are only read, the traversal holds its own reference to the plan.
+ *
+ * @param payload The payload to start from
+ * @param plan The plan being followed
+ * @param redpath The node of the plan to start at
+ * @param options The options for each request, must stay valid until the callback
+ * @param callback The function to call with the result
+ * @param context An opaque data pointer to pass to the callback function
+ * @return false if the traversal could not be started, in which case the callback will not be called
+ */
+bool getPayloadForPlanAsync(redfishPayload* payload, redPathPlan* plan, redPathNode* redpath, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
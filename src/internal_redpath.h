@@ -0,0 +1,85 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file internal_redpath.h
+ * @brief File containing the interface for compiled RedPaths.
+ *
+ * This file explains the interface for RedPath plans. A plan is a parsed RedPath that is never changed once built, so one plan
+ * can be shared by any number of traversals at once. Plans for path strings are kept in a process wide LRU cache so a path that
+ * is evaluated repeatedly is only parsed once.
+ */
+#ifndef _INT_REDPATH_H_
+#define _INT_REDPATH_H_
+
+#include <stddef.h>
+#include <redpath.h>
+
+/** A parsed RedPath shared between traversals **/
+typedef struct _redPathPlan redPathPlan;
+
+/**
+ * @brief Get the plan for a RedPath string
+ *
+ * @param path The RedPath string
+ * @return A new reference to the plan, from the cache if possible, or NULL if the path could not be parsed
+ * @see redpathPlanDecRef
+ */
+redPathPlan* redpathPlanGet(const char* path);
+
+/**
+ * @brief Make a plan from nodes the caller already parsed
+ *
+ * The plan is not cached.
+ *
+ * @param nodes The nodes, the plan takes ownership of them
+ * @return A new plan or NULL on failure, in which case the caller still owns nodes
+ * @see redpathPlanUnwrap
+ */
+redPathPlan* redpathPlanWrap(redPathNode* nodes);
+
+/**
+ * @brief Drop the last reference to a plan made by redpathPlanWrap() without freeing its nodes
+ *
+ * @param plan The plan
+ * @return The nodes, owned by the caller again
+ */
+redPathNode* redpathPlanUnwrap(redPathPlan* plan);
+
+/**
+ * @brief Get the first node of a plan
+ *
+ * The nodes must not be changed or freed.
+ *
+ * @param plan The plan
+ * @return The first node
+ */
+redPathNode* redpathPlanNodes(redPathPlan* plan);
+
+/**
+ * @brief Add a reference to a plan
+ *
+ * @param plan The plan
+ * @return The plan
+ */
+redPathPlan* redpathPlanIncRef(redPathPlan* plan);
+
+/**
+ * @brief Drop a reference to a plan, freeing it once the last reference is gone
+ *
+ * @param plan The plan, may be NULL
+ */
+void redpathPlanDecRef(redPathPlan* plan);
+
+/**
+ * @brief Set the number of plans kept in the cache
+ *
+ * @param size The most plans to keep, 0 disables the cache and frees the plans in it
+ */
+void redpathCacheSetSize(size_t size);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
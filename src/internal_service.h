@@ -24,6 +24,9 @@
 #include "queue.h"
 #include "util.h"
 
+/** The host of services created by createServiceFromSnapshot(), requests to it never leave the process **/
+#define REDFISH_REPLAY_HOST "replay://snapshot"
+
 /**
  * @brief A redfish service.
  *
@@ -100,7 +103,67 @@ typedef struct _redfishService {
     char* sessionUri;
     /** The service is being free'd **/
     bool freeing;
+    /** The SERVICE_FEATURE_* query options supported by the service, 0 until the service root has been read **/
+    unsigned int protocolFeatures;
+    /** The snapshot requests are answered from instead of the host, see createServiceFromSnapshot() **/
+    struct _redfishSnapshot* replay;
+    /** The delay added to each replayed request in microseconds **/
+    unsigned long replayLatency;
+    /** The URI each RedPath step led to, keyed by the URI it was taken from and the step, see setRedPathMemoLifetime() **/
+    json_t* pathMemo;
+    /** The number of seconds a step stays in pathMemo, 0 if steps are not remembered **/
+    unsigned int pathMemoLifetime;
+    /** A lock to regulate access to pathMemo **/
+    mutex pathMemoLock;
+    /** The service root for each root URI read so far and the time it was read, see setServiceRootLifetime() **/
+    json_t* rootCache;
+    /** The number of seconds a cached service root is used for, 0 uses it until invalidateServiceRoot() is called **/
+    unsigned int rootLifetime;
+    /** A lock to regulate access to rootCache **/
+    mutex rootCacheLock;
 } redfishService;
 
+/**
+ * @brief Check if the calling thread is the async thread of the service
+ *
+ * The sync calls wait on the async thread, so they fail rather than deadlock when called from it.
+ *
+ * @param service The service to check
+ * @return True if called on the service's async thread
+ */
+bool isOnAsyncThread(redfishService* service);
+
+/**
+ * @brief A function to run on the async thread of a service
+ *
+ * @param context The context passed to queueAsyncWork()
+ */
+typedef void (*asyncWorkCallback)(void* context);
+
+/**
+ * @brief Run a function on the async thread of a service
+ *
+ * The function runs in order with the service's queued requests, so answers that don't need the network are still delivered on the async thread.
+ *
+ * @param service The service whose async thread should run the function
+ * @param work The function to run
+ * @param context An opaque data pointer to pass to the function
+ * @return false if the work could not be queued. True otherwise
+ */
+bool queueAsyncWork(redfishService* service, asyncWorkCallback work, void* context);
+
+/**
+ * @brief Run a function on the async thread of a service once a delay has passed
+ *
+ * The thread keeps sending the service's other requests while the function waits.
+ *
+ * @param service The service whose async thread should run the function
+ * @param work The function to run
+ * @param context An opaque data pointer to pass to the function
+ * @param delay The time to wait before running the function in microseconds, 0 to run it in order like queueAsyncWork()
+ * @return false if the work could not be queued. True otherwise
+ */
+bool queueDelayedAsyncWork(redfishService* service, asyncWorkCallback work, void* context, unsigned long delay);
+
 #endif
 /* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
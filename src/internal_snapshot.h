@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file internal_snapshot.h
+ * @brief File containing the interface for internal snapshot helpers.
+ *
+ * This file explains the interface for snapshot functions shared between the library sources but not exported.
+ */
+#ifndef _INT_SNAPSHOT_H_
+#define _INT_SNAPSHOT_H_
+
+#include <stdint.h>
+#include <redfishSnapshot.h>
+#include "tape.h"
+
+/**
+ * @brief Take a reference to a snapshot
+ *
+ * @param snapshot The snapshot
+ * @return The snapshot
+ * @see cleanupSnapshot
+ */
+redfishSnapshot* snapshotIncRef(redfishSnapshot* snapshot);
+
+/**
+ * @brief Answer a GET from the snapshot of a replay service
+ *
+ * Returns right away, the caller holds the answer back for replaySnapshotDelay().
+ *
+ * @param service The replay service
+ * @param uri The URI or URL requested. A trailing '/' on the path is ignored if the URI is not found as given, a query string is not
+ * @return The stored resource or NULL if the snapshot has no such URI
+ */
+redfishPayload* replaySnapshotUri(redfishService* service, const char* uri);
+
+/**
+ * @brief Get how long a replay service takes to answer a GET
+ *
+ * @param service The replay service
+ * @param uri The URI or URL requested
+ * @return The service's replay latency or the recorded response time of the URI in microseconds, see createServiceFromSnapshot()
+ */
+unsigned long replaySnapshotDelay(redfishService* service, const char* uri);
+
+/**
+ * @brief Get a resource stored in a snapshot by position
+ *
+ * @param snapshot The snapshot
+ * @param index The position of the resource, in the same order as getSnapshotUri()
+ * @return A new reference to the resource's tape or NULL if index is out of range
+ */
+payloadTape* getSnapshotTape(redfishSnapshot* snapshot, size_t index);
+
+/**
+ * @brief Get the hash of a resource stored in a snapshot by position
+ *
+ * @param snapshot The snapshot
+ * @param index The position of the resource, in the same order as getSnapshotUri()
+ * @return The tapeHash() of the resource, recorded when the snapshot was written
+ */
+uint64_t getSnapshotHash(redfishSnapshot* snapshot, size_t index);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
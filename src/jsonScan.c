@@ -0,0 +1,488 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+
+#include "jsonScan.h"
+
+/** Nesting deeper than this is left to the parser, which has the same limit **/
+#define JSONSCAN_MAX_DEPTH 2048
+
+static const char* skipWhitespace(const char* cur, const char* end);
+static const char* skipString(const char* cur, const char* end);
+static const char* skipUnicodeEscape(const char* cur, const char* end);
+static bool readHex4(const char* cur, const char* end, unsigned int* value);
+static const char* skipNumber(const char* cur, const char* end);
+static const char* skipValue(const char* cur, const char* end, size_t depth);
+static const char* skipLiteral(const char* cur, const char* end, const char* literal, size_t length);
+
+jsonScanResult jsonScanObjectMember(const char* json, size_t length, const char* key, size_t keyLength, jsonSpan* value)
+{
+    const char* cur;
+    const char* end;
+    const char* keyStart;
+    const char* keyEnd;
+    const char* valueStart;
+    bool sawEscapedKey = false;
+    bool found = false;
+
+    if(json == NULL || key == NULL || value == NULL)
+    {
+        return JSONSCAN_UNKNOWN;
+    }
+    end = json + length;
+    cur = skipWhitespace(json, end);
+    if(cur == end || *cur != '{')
+    {
+        return JSONSCAN_UNKNOWN;
+    }
+    cur = skipWhitespace(cur+1, end);
+    if(cur < end && *cur == '}')
+    {
+        return (skipWhitespace(cur+1, end) == end) ? JSONSCAN_NOT_FOUND : JSONSCAN_UNKNOWN;
+    }
+    while(cur < end)
+    {
+        if(*cur != '"')
+        {
+            return JSONSCAN_UNKNOWN;
+        }
+        keyStart = cur+1;
+        cur = skipString(cur, end);
+        if(cur == NULL)
+        {
+            return JSONSCAN_UNKNOWN;
+        }
+        keyEnd = cur-1;
+        cur = skipWhitespace(cur, end);
+        if(cur == end || *cur != ':')
+        {
+            return JSONSCAN_UNKNOWN;
+        }
+        valueStart = skipWhitespace(cur+1, end);
+        cur = skipValue(valueStart, end, 1);
+        if(cur == NULL)
+        {
+            return JSONSCAN_UNKNOWN;
+        }
+        if(memchr(keyStart, '\\', (size_t)(keyEnd-keyStart)) != NULL)
+        {
+            //Would need to unescape to compare, let the real parser deal with it if we don't find a plain match
+            sawEscapedKey = true;
+        }
+        else if((size_t)(keyEnd-keyStart) == keyLength && memcmp(keyStart, key, keyLength) == 0)
+        {
+            //Keep going, the parser keeps the last of any duplicate keys so we need to as well
+            value->start = valueStart;
+            value->length = (size_t)(cur-valueStart);
+            found = true;
+        }
+        cur = skipWhitespace(cur, end);
+        if(cur == end)
+        {
+            return JSONSCAN_UNKNOWN;
+        }
+        if(*cur == '}')
+        {
+            //Anything but whitespace after the object makes the whole text invalid
+            if(skipWhitespace(cur+1, end) != end)
+            {
+                return JSONSCAN_UNKNOWN;
+            }
+            if(found)
+            {
+                return JSONSCAN_FOUND;
+            }
+            return (sawEscapedKey ? JSONSCAN_UNKNOWN : JSONSCAN_NOT_FOUND);
+        }
+        if(*cur != ',')
+        {
+            return JSONSCAN_UNKNOWN;
+        }
+        cur = skipWhitespace(cur+1, end);
+    }
+    return JSONSCAN_UNKNOWN;
+}
+
+jsonScanResult jsonScanObjectPath(const char* json, size_t length, const char* path, jsonSpan* value)
+{
+    jsonSpan current;
+    jsonScanResult ret = JSONSCAN_UNKNOWN;
+    size_t segmentLength;
+
+    if(json == NULL || path == NULL || value == NULL)
+    {
+        return JSONSCAN_UNKNOWN;
+    }
+    current.start = json;
+    current.length = length;
+    while(*path)
+    {
+        path += strspn(path, ".");
+        segmentLength = strcspn(path, ".");
+        if(segmentLength == 0)
+        {
+            break;
+        }
+        ret = jsonScanObjectMember(current.start, current.length, path, segmentLength, &current);
+        if(ret != JSONSCAN_FOUND)
+        {
+            return ret;
+        }
+        path += segmentLength;
+    }
+    if(ret == JSONSCAN_FOUND)
+    {
+        *value = current;
+    }
+    return ret;
+}
+
+bool jsonScanValidate(const char* json, size_t length)
+{
+    const char* cur;
+    const char* end;
+
+    if(json == NULL)
+    {
+        return false;
+    }
+    end = json + length;
+    cur = skipWhitespace(json, end);
+    if(cur == end || (*cur != '{' && *cur != '['))
+    {
+        return false;
+    }
+    cur = skipValue(cur, end, 0);
+    return (cur != NULL && skipWhitespace(cur, end) == end);
+}
+
+char jsonScanFirstChar(const char* json, size_t length)
+{
+    const char* cur;
+
+    if(json == NULL)
+    {
+        return 0;
+    }
+    cur = skipWhitespace(json, json+length);
+    if(cur == json+length)
+    {
+        return 0;
+    }
+    return *cur;
+}
+
+static const char* skipWhitespace(const char* cur, const char* end)
+{
+    while(cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r'))
+    {
+        cur++;
+    }
+    return cur;
+}
+
+/*Skip a string, checking it the way jansson would. Returns NULL if the string is not valid*/
+static const char* skipString(const char* cur, const char* end)
+{
+    unsigned char c;
+    size_t follow;
+    unsigned int codepoint;
+
+    //Skip the opening quote
+    cur++;
+    while(cur < end)
+    {
+        c = (unsigned char)*cur;
+        if(c == '"')
+        {
+            return cur+1;
+        }
+        if(c < 0x20)
+        {
+            return NULL;
+        }
+        if(c == '\\')
+        {
+            if(cur+1 >= end)
+            {
+                return NULL;
+            }
+            if(cur[1] == 'u')
+            {
+                cur = skipUnicodeEscape(cur, end);
+                if(cur == NULL)
+                {
+                    return NULL;
+                }
+                continue;
+            }
+            if(strchr("\"\\/bfnrt", cur[1]) == NULL || cur[1] == '\0')
+            {
+                return NULL;
+            }
+            cur += 2;
+            continue;
+        }
+        if(c < 0x80)
+        {
+            cur++;
+            continue;
+        }
+        //UTF-8, no overlong forms, surrogates, or anything past U+10FFFF
+        if(c >= 0xC2 && c <= 0xDF)
+        {
+            follow = 1;
+            codepoint = c & 0x1F;
+        }
+        else if(c >= 0xE0 && c <= 0xEF)
+        {
+            follow = 2;
+            codepoint = c & 0x0F;
+        }
+        else if(c >= 0xF0 && c <= 0xF4)
+        {
+            follow = 3;
+            codepoint = c & 0x07;
+        }
+        else
+        {
+            return NULL;
+        }
+        if((size_t)(end-cur) <= follow)
+        {
+            return NULL;
+        }
+        for(cur++; follow; follow--, cur++)
+        {
+            if((*cur & 0xC0) != 0x80)
+            {
+                return NULL;
+            }
+            codepoint = (codepoint << 6) | (*cur & 0x3F);
+        }
+        if((c == 0xE0 && codepoint < 0x800) || (c == 0xF0 && codepoint < 0x10000) || codepoint > 0x10FFFF ||
+           (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+/*Skip a \uXXXX escape (or surrogate pair) starting at the backslash. \u0000 and unpaired surrogates are refused like jansson does*/
+static const char* skipUnicodeEscape(const char* cur, const char* end)
+{
+    unsigned int value;
+    unsigned int low;
+
+    if(readHex4(cur+2, end, &value) == false || value == 0 || (value >= 0xDC00 && value <= 0xDFFF))
+    {
+        return NULL;
+    }
+    cur += 6;
+    if(value >= 0xD800 && value <= 0xDBFF)
+    {
+        if(end-cur < 6 || cur[0] != '\\' || cur[1] != 'u' || readHex4(cur+2, end, &low) == false || low < 0xDC00 || low > 0xDFFF)
+        {
+            return NULL;
+        }
+        cur += 6;
+    }
+    return cur;
+}
+
+static bool readHex4(const char* cur, const char* end, unsigned int* value)
+{
+    int i;
+
+    if(end-cur < 4)
+    {
+        return false;
+    }
+    *value = 0;
+    for(i = 0; i < 4; i++)
+    {
+        *value <<= 4;
+        if(cur[i] >= '0' && cur[i] <= '9')
+        {
+            *value |= (unsigned int)(cur[i] - '0');
+        }
+        else if(cur[i] >= 'a' && cur[i] <= 'f')
+        {
+            *value |= (unsigned int)(cur[i] - 'a' + 10);
+        }
+        else if(cur[i] >= 'A' && cur[i] <= 'F')
+        {
+            *value |= (unsigned int)(cur[i] - 'A' + 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*Skip a number following the JSON grammar. Returns NULL for anything jansson would refuse or might overflow on*/
+static const char* skipNumber(const char* cur, const char* end)
+{
+    const char* digits;
+    size_t intDigits;
+    long exponent = 0;
+    bool exponentNegative = false;
+    bool isReal = false;
+
+    if(cur < end && *cur == '-')
+    {
+        cur++;
+    }
+    digits = cur;
+    if(cur < end && *cur == '0')
+    {
+        cur++;
+    }
+    else
+    {
+        while(cur < end && *cur >= '0' && *cur <= '9')
+        {
+            cur++;
+        }
+    }
+    intDigits = (size_t)(cur-digits);
+    if(intDigits == 0)
+    {
+        return NULL;
+    }
+    if(cur < end && *cur == '.')
+    {
+        isReal = true;
+        digits = ++cur;
+        while(cur < end && *cur >= '0' && *cur <= '9')
+        {
+            cur++;
+        }
+        if(cur == digits)
+        {
+            return NULL;
+        }
+    }
+    if(cur < end && (*cur == 'e' || *cur == 'E'))
+    {
+        isReal = true;
+        cur++;
+        if(cur < end && (*cur == '+' || *cur == '-'))
+        {
+            exponentNegative = (*cur == '-');
+            cur++;
+        }
+        digits = cur;
+        while(cur < end && *cur >= '0' && *cur <= '9')
+        {
+            if(exponent < 100000)
+            {
+                exponent = exponent*10 + (*cur - '0');
+            }
+            cur++;
+        }
+        if(cur == digits)
+        {
+            return NULL;
+        }
+    }
+    //Leave integers that may not fit in a json_int_t and reals that may overflow a double to the parser
+    if(isReal == false && intDigits > 18)
+    {
+        return NULL;
+    }
+    if(isReal && (long)intDigits + (exponentNegative ? -exponent : exponent) > 300)
+    {
+        return NULL;
+    }
+    return cur;
+}
+
+/*Skip any value, checking everything in it. Returns NULL if the value is not valid or too deeply nested to be sure*/
+static const char* skipValue(const char* cur, const char* end, size_t depth)
+{
+    char close;
+
+    if(cur >= end)
+    {
+        return NULL;
+    }
+    switch(*cur)
+    {
+        case '"':
+            return skipString(cur, end);
+        case '{':
+        case '[':
+            if(depth >= JSONSCAN_MAX_DEPTH)
+            {
+                return NULL;
+            }
+            close = (*cur == '{') ? '}' : ']';
+            cur = skipWhitespace(cur+1, end);
+            if(cur < end && *cur == close)
+            {
+                return cur+1;
+            }
+            while(cur < end)
+            {
+                if(close == '}')
+                {
+                    if(*cur != '"')
+                    {
+                        return NULL;
+                    }
+                    cur = skipString(cur, end);
+                    if(cur == NULL)
+                    {
+                        return NULL;
+                    }
+                    cur = skipWhitespace(cur, end);
+                    if(cur == end || *cur != ':')
+                    {
+                        return NULL;
+                    }
+                    cur = skipWhitespace(cur+1, end);
+                }
+                cur = skipValue(cur, end, depth+1);
+                if(cur == NULL)
+                {
+                    return NULL;
+                }
+                cur = skipWhitespace(cur, end);
+                if(cur < end && *cur == close)
+                {
+                    return cur+1;
+                }
+                if(cur == end || *cur != ',')
+                {
+                    return NULL;
+                }
+                cur = skipWhitespace(cur+1, end);
+            }
+            return NULL;
+        case 't':
+            return skipLiteral(cur, end, "true", 4);
+        case 'f':
+            return skipLiteral(cur, end, "false", 5);
+        case 'n':
+            return skipLiteral(cur, end, "null", 4);
+        default:
+            return skipNumber(cur, end);
+    }
+}
+
+static const char* skipLiteral(const char* cur, const char* end, const char* literal, size_t length)
+{
+    if((size_t)(end-cur) < length || memcmp(cur, literal, length) != 0)
+    {
+        return NULL;
+    }
+    return cur+length;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file jsonScan.h
+ * @brief File containing the interface for the on-demand JSON scanner.
+ *
+ * This file explains the interface for locating values inside raw JSON text without building a jansson tree.
+ *
+ * The scanner checks all of the text it passes over the same way the parser would, so it only gives an answer when parsing
+ * the text would have succeeded. Anything it is not sure about is reported as JSONSCAN_UNKNOWN.
+ */
+#ifndef _JSON_SCAN_H_
+#define _JSON_SCAN_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief The result of a scan
+ */
+typedef enum {
+    /** The value does not exist in the text **/
+    JSONSCAN_NOT_FOUND,
+    /** The value was located **/
+    JSONSCAN_FOUND,
+    /** The scanner could not answer (malformed text, escaped keys, very large numbers, etc). The caller should fully parse the text **/
+    JSONSCAN_UNKNOWN
+} jsonScanResult;
+
+/**
+ * @brief A span of raw JSON text
+ */
+typedef struct
+{
+    /** The first character of the value **/
+    const char* start;
+    /** The length of the value in bytes **/
+    size_t length;
+} jsonSpan;
+
+/**
+ * @brief Locate the value of a top level member of a JSON object
+ *
+ * @param json The raw JSON text
+ * @param length The length of the JSON text
+ * @param key The member name to look for
+ * @param keyLength The length of the member name
+ * @param value Filled in with the value's text if found
+ * @return The result of the scan
+ */
+jsonScanResult jsonScanObjectMember(const char* json, size_t length, const char* key, size_t keyLength, jsonSpan* value);
+
+/**
+ * @brief Locate the value of a nested member of a JSON object
+ *
+ * Locate a member using a "." delimited path (i.e. Status.Health) scanning only the objects along the path.
+ *
+ * @param json The raw JSON text
+ * @param length The length of the JSON text
+ * @param path The "." delimited path to look for
+ * @param value Filled in with the value's text if found
+ * @return The result of the scan
+ */
+jsonScanResult jsonScanObjectPath(const char* json, size_t length, const char* path, jsonSpan* value);
+
+/**
+ * @brief Check that JSON text would parse without building anything
+ *
+ * @param json The raw JSON text
+ * @param length The length of the JSON text
+ * @return True if the text is a valid JSON object or array, false if it is not or the scanner can't be sure
+ */
+bool jsonScanValidate(const char* json, size_t length);
+
+/**
+ * @brief Get the first structural character of the JSON text
+ *
+ * @param json The raw JSON text
+ * @param length The length of the JSON text
+ * @return The first non-whitespace character (i.e. '{' for objects and '[' for arrays) or 0 if the text is empty
+ */
+char jsonScanFirstChar(const char* json, size_t length);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -8,6 +8,10 @@
 
 #include <redfish.h>
 
+#include "arena.h"
+#include "intern.h"
+#include "internal_redpath.h"
+
 libRedfishDebugFunc gDebugFunc = NULL;
 
 void libredfishSetDebugFunction(libRedfishDebugFunc debugFunc)
@@ -19,6 +23,21 @@ void libredfishSetDebugFunction(libRedfishDebugFunc debugFunc)
 #endif
 }
 
+void libredfishEnablePayloadArenas(void)
+{
+    arenaInstallAllocator();
+}
+
+void libredfishSetValueInterning(bool enable)
+{
+    internSetEnabled(enable);
+}
+
+void libredfishSetRedPathCacheSize(size_t size)
+{
+    redpathCacheSetSize(size);
+}
+
 #ifdef STANDALONE
 #include <iostream>
 #include <getopt.h>
@@ -0,0 +1,1243 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+
+#include "odataQuery.h"
+#include "redfishPayload.h"
+#include "debug.h"
+#include "util.h"
+
+/** The kinds of node in a parsed $filter expression **/
+typedef enum
+{
+    FILTER_NODE_OR,
+    FILTER_NODE_AND,
+    FILTER_NODE_NOT,
+    FILTER_NODE_COMPARE
+} filterNodeType;
+
+/** The comparison operators supported in $filter **/
+typedef enum
+{
+    FILTER_OP_EQ,
+    FILTER_OP_NE,
+    FILTER_OP_GT,
+    FILTER_OP_GE,
+    FILTER_OP_LT,
+    FILTER_OP_LE
+} filterOp;
+
+/** A node in a parsed $filter expression **/
+typedef struct _filterNode
+{
+    /** What kind of node this is **/
+    filterNodeType type;
+    /** The operator, FILTER_NODE_COMPARE only **/
+    filterOp op;
+    /** The first operand of and/or, the operand of not **/
+    struct _filterNode* left;
+    /** The second operand of and/or **/
+    struct _filterNode* right;
+    /** The property being compared, FILTER_NODE_COMPARE only **/
+    char* property;
+    /** The value the property is compared to, FILTER_NODE_COMPARE only **/
+    json_t* literal;
+} filterNode;
+
+/** The kinds of token in a $filter expression **/
+typedef enum
+{
+    FILTER_TOKEN_END,
+    FILTER_TOKEN_OPEN,
+    FILTER_TOKEN_CLOSE,
+    FILTER_TOKEN_WORD,
+    FILTER_TOKEN_STRING,
+    FILTER_TOKEN_ERROR
+} filterTokenType;
+
+/** The state of the $filter tokenizer **/
+typedef struct
+{
+    /** The next character to read **/
+    const char* pos;
+    /** The type of the current token **/
+    filterTokenType type;
+    /** The start of the current token, for strings this excludes the quotes **/
+    const char* start;
+    /** The length of the current token **/
+    size_t length;
+} filterLexer;
+
+/** State for applying $filter to members that had to be fetched first **/
+typedef struct
+{
+    /** The response being filtered **/
+    redfishPayload* payload;
+    /** The options for the original request **/
+    redfishAsyncOptions* options;
+    /** The query options to apply **/
+    unsigned int local;
+    /** The HTTP status of the original response **/
+    unsigned short httpCode;
+    /** The original callback **/
+    redfishAsyncCallback callback;
+    /** The original context **/
+    void* context;
+    /** The options used to fetch the members **/
+    redfishAsyncOptions memberOptions;
+    /** The fetched JSON for each member, NULL for members that were not fetched **/
+    json_t** members;
+    /** The number of fetches still outstanding, plus one while they are still being started **/
+    size_t left;
+} localQueryContext;
+
+/** The context for the fetch of a single member **/
+typedef struct
+{
+    /** The overall context **/
+    localQueryContext* parent;
+    /** The position of the member in Members **/
+    size_t index;
+} memberFetchContext;
+
+static bool filterNextToken(filterLexer* lexer);
+static bool filterTokenIs(filterLexer* lexer, const char* word);
+static filterNode* parseFilterOr(filterLexer* lexer);
+static filterNode* parseFilterAnd(filterLexer* lexer);
+static filterNode* parseFilterNot(filterLexer* lexer);
+static filterNode* parseFilterCompare(filterLexer* lexer);
+static filterNode* parseFilter(const char* filter);
+static void freeFilter(filterNode* node);
+static bool evalFilter(filterNode* node, json_t* json);
+static json_t* getFilterProperty(json_t* json, const char* property);
+static bool isLinkOnly(json_t* json);
+static json_t* keepValue(redfishPayload* payload, json_t* value);
+static json_t* selectObject(redfishPayload* payload, json_t* json, json_t* items, bool isCollection);
+static json_t* parseSelect(const char* select);
+static json_t* buildLocalResult(redfishPayload* payload, redfishAsyncOptions* options, unsigned int local, json_t** fetched);
+static void finishLocalQuery(localQueryContext* myContext);
+static void gotMemberForFilter(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static filterNode* newFilterNode(filterNodeType type, filterNode* left, filterNode* right);
+static json_t* filterLiteral(filterLexer* lexer);
+static bool appendEncoded(char** buffer, size_t* length, size_t* capacity, const char* str, bool encode);
+
+unsigned int odataQueryRequested(const redfishAsyncOptions* options)
+{
+    unsigned int ret = 0;
+
+    if(options == NULL)
+    {
+        return 0;
+    }
+    if(options->select)
+    {
+        ret |= SERVICE_FEATURE_SELECT;
+    }
+    if(options->filter)
+    {
+        ret |= SERVICE_FEATURE_FILTER;
+    }
+    if(options->top || options->skip)
+    {
+        ret |= SERVICE_FEATURE_TOP_SKIP;
+    }
+    return ret;
+}
+
+bool odataQueryCopyOptions(redfishAsyncOptions* dest, const redfishAsyncOptions* src)
+{
+    *dest = *src;
+    dest->select = safeStrdup(src->select);
+    dest->filter = safeStrdup(src->filter);
+    if((src->select && dest->select == NULL) || (src->filter && dest->filter == NULL))
+    {
+        odataQueryFreeOptions(dest);
+        return false;
+    }
+    return true;
+}
+
+void odataQueryFreeOptions(redfishAsyncOptions* options)
+{
+    free((char*)options->select);
+    free((char*)options->filter);
+    options->select = NULL;
+    options->filter = NULL;
+}
+
+redfishAsyncOptions* odataQueryStripOptions(redfishAsyncOptions* dest, const redfishAsyncOptions* src)
+{
+    if(src == NULL)
+    {
+        return NULL;
+    }
+    *dest = *src;
+    dest->select = NULL;
+    dest->filter = NULL;
+    dest->top = 0;
+    dest->skip = 0;
+    dest->maxMembers = 0;
+    return dest;
+}
+
+unsigned int odataQueryFeaturesFromServiceRoot(json_t* root)
+{
+    json_t* features = json_object_get(root, "ProtocolFeaturesSupported");
+    unsigned int ret = 0;
+
+    if(json_is_true(json_object_get(features, "SelectQuery")))
+    {
+        ret |= SERVICE_FEATURE_SELECT;
+    }
+    if(json_is_true(json_object_get(features, "FilterQuery")))
+    {
+        ret |= SERVICE_FEATURE_FILTER;
+    }
+    if(json_is_true(json_object_get(features, "TopSkipQuery")))
+    {
+        ret |= SERVICE_FEATURE_TOP_SKIP;
+    }
+    //'.' expands everything except Links, which is what NoLinks advertises
+    if(json_is_true(json_object_get(json_object_get(features, "ExpandQuery"), "NoLinks")))
+    {
+        ret |= SERVICE_FEATURE_EXPAND;
+        if(json_is_true(json_object_get(json_object_get(features, "ExpandQuery"), "Levels")))
+        {
+            ret |= SERVICE_FEATURE_EXPAND_LEVELS;
+        }
+    }
+    return ret;
+}
+
+void odataQuerySplit(unsigned int features, const redfishAsyncOptions* options, unsigned int* send, unsigned int* local)
+{
+    unsigned int requested = odataQueryRequested(options);
+    unsigned int mySend;
+
+    mySend = requested & features;
+    if((requested & SERVICE_FEATURE_FILTER) && !(features & SERVICE_FEATURE_FILTER))
+    {
+        //$top and $skip apply after $filter, and $filter may need properties $select would drop, so do it all here
+        mySend = 0;
+    }
+    if(send)
+    {
+        *send = mySend;
+    }
+    if(local)
+    {
+        *local = requested & ~mySend;
+    }
+}
+
+char* odataQueryString(const char* uri, const redfishAsyncOptions* options, unsigned int send)
+{
+    char* ret;
+    size_t length = 0;
+    size_t capacity = 64;
+    char number[32];
+    bool ok = true;
+    const char* separator = (strchr(uri, '?') == NULL) ? "?" : "&";
+
+    ret = (char*)malloc(capacity);
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    ret[0] = 0;
+    if(send & SERVICE_FEATURE_SELECT)
+    {
+        ok = ok && appendEncoded(&ret, &length, &capacity, separator, false) && appendEncoded(&ret, &length, &capacity, "$select=", false) && appendEncoded(&ret, &length, &capacity, options->select, true);
+        separator = "&";
+    }
+    if(send & SERVICE_FEATURE_FILTER)
+    {
+        ok = ok && appendEncoded(&ret, &length, &capacity, separator, false) && appendEncoded(&ret, &length, &capacity, "$filter=", false) && appendEncoded(&ret, &length, &capacity, options->filter, true);
+        separator = "&";
+    }
+    if((send & SERVICE_FEATURE_TOP_SKIP) && options->top)
+    {
+        snprintf(number, sizeof(number), "%lu", (unsigned long)options->top);
+        ok = ok && appendEncoded(&ret, &length, &capacity, separator, false) && appendEncoded(&ret, &length, &capacity, "$top=", false) && appendEncoded(&ret, &length, &capacity, number, true);
+        separator = "&";
+    }
+    if((send & SERVICE_FEATURE_TOP_SKIP) && options->skip)
+    {
+        snprintf(number, sizeof(number), "%lu", (unsigned long)options->skip);
+        ok = ok && appendEncoded(&ret, &length, &capacity, separator, false) && appendEncoded(&ret, &length, &capacity, "$skip=", false) && appendEncoded(&ret, &length, &capacity, number, true);
+    }
+    if(!ok)
+    {
+        free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+char* odataFilterFromRedPath(const char* propName, RedPathOp op, const char* value)
+{
+    static const char* ops[] = {"eq", "ne", "lt", "gt", "le", "ge"};
+    char* ret;
+    char* property;
+    char* quoted;
+    char* numberEnd;
+    const char* start;
+    const char* end;
+    long long integer;
+    size_t length = 0;
+    size_t size;
+    size_t i;
+    size_t j;
+
+    if(propName == NULL || value == NULL || op > REDPATH_OP_GREATER_EQUAL)
+    {
+        return NULL;
+    }
+    //RedPath uses '.' for nested properties where $filter uses '/'
+    property = (char*)malloc(strlen(propName) + 1);
+    if(property == NULL)
+    {
+        return NULL;
+    }
+    for(start = propName; *start; start = end)
+    {
+        while(*start == '.')
+        {
+            start++;
+        }
+        end = start + strcspn(start, ".");
+        for(i = 0; start + i < end; i++)
+        {
+            if(!isalnum((unsigned char)start[i]) && strchr("_@#", start[i]) == NULL)
+            {
+                free(property);
+                return NULL;
+            }
+        }
+        if(end == start)
+        {
+            break;
+        }
+        if(length)
+        {
+            property[length++] = '/';
+        }
+        memcpy(property + length, start, (size_t)(end - start));
+        length += (size_t)(end - start);
+    }
+    property[length] = 0;
+    if(length == 0)
+    {
+        free(property);
+        return NULL;
+    }
+    quoted = (char*)malloc(strlen(value) * 2 + 1);
+    if(quoted == NULL)
+    {
+        free(property);
+        return NULL;
+    }
+    for(i = 0, j = 0; value[i]; i++)
+    {
+        quoted[j++] = value[i];
+        if(value[i] == '\'')
+        {
+            quoted[j++] = '\'';
+        }
+    }
+    quoted[j] = 0;
+    size = (length * 2) + (j * 2) + 64;
+    ret = (char*)malloc(size);
+    if(ret != NULL)
+    {
+        integer = strtoll(value, &numberEnd, 0);
+        if(numberEnd != value && *numberEnd == 0)
+        {
+            snprintf(ret, size, "(%s %s %lld or %s %s '%s')", property, ops[op], integer, property, ops[op], quoted);
+        }
+        else if(strcmp(value, "true") == 0 || strcmp(value, "false") == 0 || strcmp(value, "null") == 0)
+        {
+            if(op == REDPATH_OP_EQUAL || op == REDPATH_OP_NOTEQUAL)
+            {
+                snprintf(ret, size, "(%s %s %s or %s %s '%s')", property, ops[op], value, property, ops[op], quoted);
+            }
+            else
+            {
+                free(ret);
+                ret = NULL;
+            }
+        }
+        else
+        {
+            snprintf(ret, size, "%s %s '%s'", property, ops[op], quoted);
+        }
+    }
+    free(property);
+    free(quoted);
+    return ret;
+}
+
+char* odataCollectionUri(const char* uri, unsigned int features, const char* filter)
+{
+    char* ret;
+    size_t length;
+    size_t capacity;
+    bool ok = true;
+    const char* separator = (strchr(uri, '?') == NULL) ? "?" : "&";
+
+    if(!(features & SERVICE_FEATURE_FILTER))
+    {
+        filter = NULL;
+    }
+    if(filter == NULL && !(features & SERVICE_FEATURE_EXPAND))
+    {
+        return NULL;
+    }
+    length = strlen(uri);
+    capacity = length + 64;
+    ret = (char*)malloc(capacity);
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    memcpy(ret, uri, length + 1);
+    if(filter)
+    {
+        ok = appendEncoded(&ret, &length, &capacity, separator, false) && appendEncoded(&ret, &length, &capacity, "$filter=", false) && appendEncoded(&ret, &length, &capacity, filter, true);
+        separator = "&";
+    }
+    if(features & SERVICE_FEATURE_EXPAND)
+    {
+        ok = ok && appendEncoded(&ret, &length, &capacity, separator, false) && appendEncoded(&ret, &length, &capacity, (features & SERVICE_FEATURE_EXPAND_LEVELS) ? "$expand=.($levels=1)" : "$expand=.", false);
+    }
+    if(!ok)
+    {
+        free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+void odataQueryApplyLocally(redfishPayload* payload, redfishAsyncOptions* options, unsigned int local, unsigned short httpCode, redfishAsyncCallback callback, void* context)
+{
+    localQueryContext* myContext;
+    memberFetchContext* fetch;
+    json_t* members;
+    json_t* member;
+    char* uri;
+    size_t count;
+    size_t i;
+
+    members = json_object_get(getPayloadJson(payload), "Members");
+    count = json_array_size(members);
+    myContext = (localQueryContext*)calloc(1, sizeof(localQueryContext));
+    if(myContext == NULL)
+    {
+        cleanupPayload(payload);
+        callback(false, 0xFFFF, NULL, context);
+        return;
+    }
+    myContext->payload = payload;
+    myContext->options = options;
+    myContext->local = local;
+    myContext->httpCode = httpCode;
+    myContext->callback = callback;
+    myContext->context = context;
+    myContext->left = 1;
+    if((local & SERVICE_FEATURE_FILTER) && count > 0)
+    {
+        myContext->members = (json_t**)calloc(count, sizeof(json_t*));
+        if(myContext->members == NULL)
+        {
+            free(myContext);
+            cleanupPayload(payload);
+            callback(false, 0xFFFF, NULL, context);
+            return;
+        }
+        //The members are only fetched to evaluate the filter, no query options for them
+        myContext->memberOptions.accept = REDFISH_ACCEPT_JSON;
+        myContext->memberOptions.timeout = options->timeout;
+        myContext->memberOptions.bodyHandling = REDFISH_BODY_PARSE;
+        //All of the callbacks run on the service's async thread, as does this, so the count needs no lock
+        for(i = 0; i < count; i++)
+        {
+            member = json_array_get(members, i);
+            if(!isLinkOnly(member))
+            {
+                continue;
+            }
+            fetch = (memberFetchContext*)malloc(sizeof(memberFetchContext));
+            if(fetch == NULL)
+            {
+                continue;
+            }
+            fetch->parent = myContext;
+            fetch->index = i;
+            uri = safeStrdup(json_string_value(json_object_get(member, "@odata.id")));
+            myContext->left++;
+            if(uri == NULL || getUriFromServiceAsync(payload->service, uri, &myContext->memberOptions, gotMemberForFilter, fetch) == false)
+            {
+                REDFISH_DEBUG_WARNING_PRINT("%s: Unable to get member %s to filter\n", __func__, uri);
+                myContext->left--;
+                free(fetch);
+            }
+            free(uri);
+        }
+    }
+    myContext->left--;
+    if(myContext->left == 0)
+    {
+        finishLocalQuery(myContext);
+    }
+}
+
+static void gotMemberForFilter(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    memberFetchContext* fetch = (memberFetchContext*)context;
+    localQueryContext* myContext = fetch->parent;
+
+    if(success && httpCode < 300 && payload)
+    {
+        myContext->members[fetch->index] = json_deep_copy(getPayloadJson(payload));
+    }
+    cleanupPayload(payload);
+    free(fetch);
+    myContext->left--;
+    if(myContext->left == 0)
+    {
+        finishLocalQuery(myContext);
+    }
+}
+
+static void finishLocalQuery(localQueryContext* myContext)
+{
+    json_t* result;
+    redfishPayload* ret = NULL;
+    size_t count;
+    size_t i;
+
+    result = buildLocalResult(myContext->payload, myContext->options, myContext->local, myContext->members);
+    if(result)
+    {
+        ret = createRedfishPayload(result, myContext->payload->service);
+    }
+    else
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to apply query options to response\n", __func__);
+    }
+    if(myContext->members)
+    {
+        count = json_array_size(json_object_get(getPayloadJson(myContext->payload), "Members"));
+        for(i = 0; i < count; i++)
+        {
+            json_decref(myContext->members[i]);
+        }
+        free(myContext->members);
+    }
+    cleanupPayload(myContext->payload);
+    myContext->callback(ret != NULL, (ret != NULL) ? myContext->httpCode : 0xFFFF, ret, myContext->context);
+    free(myContext);
+}
+
+static json_t* buildLocalResult(redfishPayload* payload, redfishAsyncOptions* options, unsigned int local, json_t** fetched)
+{
+    json_t* json = getPayloadJson(payload);
+    json_t* members;
+    json_t* newMembers;
+    json_t* member;
+    json_t* items = NULL;
+    json_t* ret;
+    json_t* tmp;
+    const char* key;
+    filterNode* filter = NULL;
+    size_t i;
+    size_t count;
+    size_t matched = 0;
+    size_t skip;
+    size_t top;
+
+    if(!json_is_object(json))
+    {
+        return keepValue(payload, json);
+    }
+    if(local & SERVICE_FEATURE_FILTER)
+    {
+        filter = parseFilter(options->filter);
+        if(filter == NULL)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to parse filter %s\n", __func__, options->filter);
+            return NULL;
+        }
+    }
+    if(local & SERVICE_FEATURE_SELECT)
+    {
+        items = parseSelect(options->select);
+        if(items == NULL)
+        {
+            freeFilter(filter);
+            return NULL;
+        }
+    }
+    members = json_object_get(json, "Members");
+    newMembers = NULL;
+    if(json_is_array(members) && (local & (SERVICE_FEATURE_FILTER|SERVICE_FEATURE_TOP_SKIP|SERVICE_FEATURE_SELECT)))
+    {
+        newMembers = json_array();
+        skip = (local & SERVICE_FEATURE_TOP_SKIP) ? options->skip : 0;
+        top = ((local & SERVICE_FEATURE_TOP_SKIP) && options->top) ? options->top : (size_t)-1;
+        count = json_array_size(members);
+        for(i = 0; i < count; i++)
+        {
+            member = json_array_get(members, i);
+            if(filter && !evalFilter(filter, (fetched && fetched[i]) ? fetched[i] : member))
+            {
+                continue;
+            }
+            matched++;
+            if(matched <= skip || matched > skip + top)
+            {
+                continue;
+            }
+            if(items && !isLinkOnly(member))
+            {
+                tmp = selectObject(payload, member, items, false);
+            }
+            else
+            {
+                tmp = keepValue(payload, member);
+            }
+            json_array_append_new(newMembers, tmp);
+        }
+    }
+
+    if(items)
+    {
+        ret = selectObject(payload, json, items, (newMembers != NULL));
+    }
+    else
+    {
+        ret = json_object();
+        json_object_foreach(json, key, member)
+        {
+            if(newMembers && strcmp(key, "Members") == 0)
+            {
+                continue;
+            }
+            json_object_set_new(ret, key, keepValue(payload, member));
+        }
+    }
+    freeFilter(filter);
+    json_decref(items);
+    if(newMembers)
+    {
+        json_object_set_new(ret, "Members", newMembers);
+        if(local & SERVICE_FEATURE_FILTER)
+        {
+            json_object_set_new(ret, "Members@odata.count", json_integer((json_int_t)matched));
+        }
+    }
+    return ret;
+}
+
+static json_t* keepValue(redfishPayload* payload, json_t* value)
+{
+    //Arena JSON goes away with the original payload, everything else can just be shared
+    if(payload->arena)
+    {
+        return json_deep_copy(value);
+    }
+    return json_incref(value);
+}
+
+static bool isLinkOnly(json_t* json)
+{
+    return json_is_object(json) && json_object_size(json) == 1 && json_is_string(json_object_get(json, "@odata.id"));
+}
+
+static json_t* parseSelect(const char* select)
+{
+    json_t* ret = json_array();
+    const char* start = select;
+    const char* end;
+
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    while(*start)
+    {
+        while(*start == ' ')
+        {
+            start++;
+        }
+        end = strchr(start, ',');
+        if(end == NULL)
+        {
+            end = start + strlen(start);
+        }
+        if(end > start)
+        {
+            json_array_append_new(ret, json_stringn(start, (size_t)(end - start)));
+        }
+        start = (*end) ? end + 1 : end;
+    }
+    return ret;
+}
+
+static json_t* selectObject(redfishPayload* payload, json_t* json, json_t* items, bool isCollection)
+{
+    json_t* ret = json_object();
+    json_t* subItems;
+    json_t* item;
+    json_t* value;
+    const char* key;
+    const char* path;
+    const char* slash;
+    size_t keyLength;
+    size_t i;
+    bool whole;
+
+    json_object_foreach(json, key, value)
+    {
+        if(strncmp(key, "@odata.", 7) == 0)
+        {
+            json_object_set_new(ret, key, keepValue(payload, value));
+            continue;
+        }
+        if(isCollection && strncmp(key, "Members", 7) == 0)
+        {
+            //The caller fills in Members, keep the annotations that go with it
+            if(key[7] == '@')
+            {
+                json_object_set_new(ret, key, keepValue(payload, value));
+            }
+            continue;
+        }
+        keyLength = strlen(key);
+        whole = false;
+        subItems = NULL;
+        json_array_foreach(items, i, item)
+        {
+            path = json_string_value(item);
+            if(strcmp(path, "*") == 0)
+            {
+                whole = true;
+                break;
+            }
+            if(strncmp(path, key, keyLength) != 0)
+            {
+                continue;
+            }
+            if(path[keyLength] == 0)
+            {
+                whole = true;
+                break;
+            }
+            slash = path + keyLength;
+            if(*slash == '/' && slash[1] != 0)
+            {
+                if(subItems == NULL)
+                {
+                    subItems = json_array();
+                }
+                json_array_append_new(subItems, json_string(slash + 1));
+            }
+        }
+        if(whole || (subItems && !json_is_object(value)))
+        {
+            json_object_set_new(ret, key, keepValue(payload, value));
+        }
+        else if(subItems)
+        {
+            json_object_set_new(ret, key, selectObject(payload, value, subItems, false));
+        }
+        json_decref(subItems);
+    }
+    return ret;
+}
+
+static json_t* getFilterProperty(json_t* json, const char* property)
+{
+    const char* start = property;
+    const char* end;
+    char name[128];
+    size_t length;
+
+    while(json && *start)
+    {
+        end = start + strcspn(start, "/");
+        length = (size_t)(end - start);
+        if(length >= sizeof(name))
+        {
+            return NULL;
+        }
+        memcpy(name, start, length);
+        name[length] = 0;
+        json = json_object_get(json, name);
+        start = (*end) ? end + 1 : end;
+    }
+    return json;
+}
+
+static bool evalFilter(filterNode* node, json_t* json)
+{
+    json_t* value;
+    double left;
+    double right;
+    int cmp;
+
+    switch(node->type)
+    {
+        case FILTER_NODE_OR:
+            return evalFilter(node->left, json) || evalFilter(node->right, json);
+        case FILTER_NODE_AND:
+            return evalFilter(node->left, json) && evalFilter(node->right, json);
+        case FILTER_NODE_NOT:
+            return !evalFilter(node->left, json);
+        default:
+            break;
+    }
+    value = getFilterProperty(json, node->property);
+    if(json_is_string(node->literal))
+    {
+        if(!json_is_string(value))
+        {
+            return node->op == FILTER_OP_NE;
+        }
+        cmp = strcmp(json_string_value(value), json_string_value(node->literal));
+    }
+    else if(json_is_number(node->literal))
+    {
+        if(!json_is_number(value))
+        {
+            return node->op == FILTER_OP_NE;
+        }
+        if(json_is_integer(value) && json_is_integer(node->literal))
+        {
+            cmp = (json_integer_value(value) > json_integer_value(node->literal)) - (json_integer_value(value) < json_integer_value(node->literal));
+        }
+        else
+        {
+            left = json_number_value(value);
+            right = json_number_value(node->literal);
+            cmp = (left > right) - (left < right);
+        }
+    }
+    else
+    {
+        //true, false and null only compare for equality, a missing property is equal to null
+        cmp = json_equal((value) ? value : json_null(), node->literal) ? 0 : 1;
+        if(node->op != FILTER_OP_EQ && node->op != FILTER_OP_NE)
+        {
+            return false;
+        }
+    }
+    switch(node->op)
+    {
+        case FILTER_OP_EQ:
+            return cmp == 0;
+        case FILTER_OP_NE:
+            return cmp != 0;
+        case FILTER_OP_GT:
+            return cmp > 0;
+        case FILTER_OP_GE:
+            return cmp >= 0;
+        case FILTER_OP_LT:
+            return cmp < 0;
+        case FILTER_OP_LE:
+            return cmp <= 0;
+    }
+    return false;
+}
+
+static filterNode* parseFilter(const char* filter)
+{
+    filterLexer lexer;
+    filterNode* ret;
+
+    lexer.pos = filter;
+    if(filterNextToken(&lexer) == false)
+    {
+        return NULL;
+    }
+    ret = parseFilterOr(&lexer);
+    if(ret && lexer.type != FILTER_TOKEN_END)
+    {
+        freeFilter(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+static void freeFilter(filterNode* node)
+{
+    if(node == NULL)
+    {
+        return;
+    }
+    freeFilter(node->left);
+    freeFilter(node->right);
+    free(node->property);
+    json_decref(node->literal);
+    free(node);
+}
+
+static bool filterNextToken(filterLexer* lexer)
+{
+    const char* pos = lexer->pos;
+
+    while(*pos == ' ' || *pos == '\t')
+    {
+        pos++;
+    }
+    lexer->start = pos;
+    lexer->length = 0;
+    if(*pos == 0)
+    {
+        lexer->type = FILTER_TOKEN_END;
+    }
+    else if(*pos == '(' || *pos == ')')
+    {
+        lexer->type = (*pos == '(') ? FILTER_TOKEN_OPEN : FILTER_TOKEN_CLOSE;
+        lexer->length = 1;
+        pos++;
+    }
+    else if(*pos == '\'')
+    {
+        //Strings end at the first lone quote, '' is an escaped quote
+        pos++;
+        lexer->start = pos;
+        while(*pos)
+        {
+            if(*pos == '\'')
+            {
+                if(pos[1] != '\'')
+                {
+                    break;
+                }
+                pos++;
+            }
+            pos++;
+        }
+        if(*pos == 0)
+        {
+            lexer->type = FILTER_TOKEN_ERROR;
+            lexer->pos = pos;
+            return false;
+        }
+        lexer->type = FILTER_TOKEN_STRING;
+        lexer->length = (size_t)(pos - lexer->start);
+        pos++;
+    }
+    else
+    {
+        while(*pos && *pos != ' ' && *pos != '\t' && *pos != '(' && *pos != ')' && *pos != '\'')
+        {
+            pos++;
+        }
+        lexer->type = FILTER_TOKEN_WORD;
+        lexer->length = (size_t)(pos - lexer->start);
+    }
+    lexer->pos = pos;
+    return true;
+}
+
+static bool filterTokenIs(filterLexer* lexer, const char* word)
+{
+    return lexer->type == FILTER_TOKEN_WORD && strlen(word) == lexer->length && strncmp(lexer->start, word, lexer->length) == 0;
+}
+
+static filterNode* newFilterNode(filterNodeType type, filterNode* left, filterNode* right)
+{
+    filterNode* ret = (filterNode*)calloc(1, sizeof(filterNode));
+
+    if(ret == NULL)
+    {
+        freeFilter(left);
+        freeFilter(right);
+        return NULL;
+    }
+    ret->type = type;
+    ret->left = left;
+    ret->right = right;
+    return ret;
+}
+
+static filterNode* parseFilterOr(filterLexer* lexer)
+{
+    filterNode* ret = parseFilterAnd(lexer);
+    filterNode* right;
+
+    while(ret && filterTokenIs(lexer, "or"))
+    {
+        if(filterNextToken(lexer) == false)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        right = parseFilterAnd(lexer);
+        if(right == NULL)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        ret = newFilterNode(FILTER_NODE_OR, ret, right);
+    }
+    return ret;
+}
+
+static filterNode* parseFilterAnd(filterLexer* lexer)
+{
+    filterNode* ret = parseFilterNot(lexer);
+    filterNode* right;
+
+    while(ret && filterTokenIs(lexer, "and"))
+    {
+        if(filterNextToken(lexer) == false)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        right = parseFilterNot(lexer);
+        if(right == NULL)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        ret = newFilterNode(FILTER_NODE_AND, ret, right);
+    }
+    return ret;
+}
+
+static filterNode* parseFilterNot(filterLexer* lexer)
+{
+    filterNode* ret;
+
+    if(filterTokenIs(lexer, "not"))
+    {
+        if(filterNextToken(lexer) == false)
+        {
+            return NULL;
+        }
+        ret = parseFilterNot(lexer);
+        if(ret == NULL)
+        {
+            return NULL;
+        }
+        return newFilterNode(FILTER_NODE_NOT, ret, NULL);
+    }
+    if(lexer->type == FILTER_TOKEN_OPEN)
+    {
+        if(filterNextToken(lexer) == false)
+        {
+            return NULL;
+        }
+        ret = parseFilterOr(lexer);
+        if(ret == NULL)
+        {
+            return NULL;
+        }
+        if(lexer->type != FILTER_TOKEN_CLOSE || filterNextToken(lexer) == false)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        return ret;
+    }
+    return parseFilterCompare(lexer);
+}
+
+static json_t* filterLiteral(filterLexer* lexer)
+{
+    json_t* ret;
+    char* buffer;
+    char* end;
+    size_t i;
+    size_t j;
+    long long integer;
+    double real;
+
+    if(lexer->type == FILTER_TOKEN_STRING)
+    {
+        buffer = (char*)malloc(lexer->length + 1);
+        if(buffer == NULL)
+        {
+            return NULL;
+        }
+        for(i = 0, j = 0; i < lexer->length; i++, j++)
+        {
+            buffer[j] = lexer->start[i];
+            if(lexer->start[i] == '\'')
+            {
+                i++;
+            }
+        }
+        ret = json_stringn(buffer, j);
+        free(buffer);
+        return ret;
+    }
+    if(lexer->type != FILTER_TOKEN_WORD)
+    {
+        return NULL;
+    }
+    if(filterTokenIs(lexer, "true"))
+    {
+        return json_true();
+    }
+    if(filterTokenIs(lexer, "false"))
+    {
+        return json_false();
+    }
+    if(filterTokenIs(lexer, "null"))
+    {
+        return json_null();
+    }
+    buffer = (char*)malloc(lexer->length + 1);
+    if(buffer == NULL)
+    {
+        return NULL;
+    }
+    memcpy(buffer, lexer->start, lexer->length);
+    buffer[lexer->length] = 0;
+    ret = NULL;
+    integer = strtoll(buffer, &end, 10);
+    if(end != buffer && *end == 0)
+    {
+        ret = json_integer((json_int_t)integer);
+    }
+    else
+    {
+        real = strtod(buffer, &end);
+        if(end != buffer && *end == 0)
+        {
+            ret = json_real(real);
+        }
+    }
+    free(buffer);
+    return ret;
+}
+
+static filterNode* parseFilterCompare(filterLexer* lexer)
+{
+    static const char* ops[] = {"eq", "ne", "gt", "ge", "lt", "le"};
+    static const filterOp mirrored[] = {FILTER_OP_EQ, FILTER_OP_NE, FILTER_OP_LT, FILTER_OP_LE, FILTER_OP_GT, FILTER_OP_GE};
+    filterNode* ret;
+    size_t i;
+    bool literalFirst;
+
+    if(lexer->type != FILTER_TOKEN_WORD && lexer->type != FILTER_TOKEN_STRING)
+    {
+        return NULL;
+    }
+    ret = newFilterNode(FILTER_NODE_COMPARE, NULL, NULL);
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    ret->literal = filterLiteral(lexer);
+    literalFirst = (ret->literal != NULL);
+    if(!literalFirst)
+    {
+        ret->property = (char*)malloc(lexer->length + 1);
+        if(ret->property == NULL)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        memcpy(ret->property, lexer->start, lexer->length);
+        ret->property[lexer->length] = 0;
+    }
+    if(filterNextToken(lexer) == false)
+    {
+        freeFilter(ret);
+        return NULL;
+    }
+    for(i = 0; i < sizeof(ops)/sizeof(ops[0]); i++)
+    {
+        if(filterTokenIs(lexer, ops[i]))
+        {
+            break;
+        }
+    }
+    if(i == sizeof(ops)/sizeof(ops[0]) || filterNextToken(lexer) == false)
+    {
+        freeFilter(ret);
+        return NULL;
+    }
+    ret->op = (filterOp)i;
+    if(literalFirst)
+    {
+        //'Enabled' eq Status/State is the same as Status/State eq 'Enabled'
+        ret->op = mirrored[i];
+        if(lexer->type != FILTER_TOKEN_WORD)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        ret->property = (char*)malloc(lexer->length + 1);
+        if(ret->property == NULL)
+        {
+            freeFilter(ret);
+            return NULL;
+        }
+        memcpy(ret->property, lexer->start, lexer->length);
+        ret->property[lexer->length] = 0;
+    }
+    else
+    {
+        ret->literal = filterLiteral(lexer);
+        if(ret->literal == NULL)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: %s is not compared to a literal\n", __func__, ret->property);
+            freeFilter(ret);
+            return NULL;
+        }
+    }
+    if(filterNextToken(lexer) == false)
+    {
+        freeFilter(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+static bool appendEncoded(char** buffer, size_t* length, size_t* capacity, const char* str, bool encode)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    unsigned char c;
+    char* tmp;
+
+    for(; *str; str++)
+    {
+        if(*length + 4 > *capacity)
+        {
+            tmp = (char*)realloc(*buffer, (*capacity) * 2);
+            if(tmp == NULL)
+            {
+                return false;
+            }
+            *buffer = tmp;
+            *capacity *= 2;
+        }
+        c = (unsigned char)*str;
+        if(!encode || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || strchr("-._~!$'()*,/:;@?", c) != NULL)
+        {
+            (*buffer)[(*length)++] = (char)c;
+        }
+        else
+        {
+            (*buffer)[(*length)++] = '%';
+            (*buffer)[(*length)++] = hex[c >> 4];
+            (*buffer)[(*length)++] = hex[c & 0xF];
+        }
+    }
+    (*buffer)[*length] = 0;
+    return true;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file odataQuery.h
+ * @brief File containing the interface for OData query options.
+ *
+ * This file explains the interface used to send the $select, $filter, $top and $skip query options to a service and to
+ * apply them locally when the service does not support them.
+ */
+#ifndef _ODATA_QUERY_H_
+#define _ODATA_QUERY_H_
+
+#include <stdbool.h>
+#include <jansson.h>
+
+#include "redfishService.h"
+#include "redpath.h"
+
+/** The service root has been read, the other SERVICE_FEATURE_* bits are valid **/
+#define SERVICE_FEATURES_KNOWN   0x00000001
+/** The service supports $select **/
+#define SERVICE_FEATURE_SELECT   0x00000002
+/** The service supports $filter **/
+#define SERVICE_FEATURE_FILTER   0x00000004
+/** The service supports $top and $skip **/
+#define SERVICE_FEATURE_TOP_SKIP 0x00000008
+/** The service supports $expand of subordinate resources ('.') **/
+#define SERVICE_FEATURE_EXPAND   0x00000010
+/** The service supports $levels within $expand **/
+#define SERVICE_FEATURE_EXPAND_LEVELS 0x00000020
+
+/**
+ * @brief Get the query options set in a set of async options
+ *
+ * @param options The options, may be NULL
+ * @return The SERVICE_FEATURE_* bits for the query options that are set
+ */
+unsigned int odataQueryRequested(const redfishAsyncOptions* options);
+
+/**
+ * @brief Copy a caller's async options to keep past the call
+ *
+ * select and filter are copied too, so the caller may free or reuse theirs as soon as the call returns.
+ *
+ * @param dest The options to fill in
+ * @param src The caller's options
+ * @return false if a string could not be copied, dest is left with nothing to free. True otherwise
+ * @see odataQueryFreeOptions
+ */
+bool odataQueryCopyOptions(redfishAsyncOptions* dest, const redfishAsyncOptions* src);
+
+/**
+ * @brief Free the strings of options filled in by odataQueryCopyOptions()
+ *
+ * @param options The options, the structure itself is not freed
+ */
+void odataQueryFreeOptions(redfishAsyncOptions* options);
+
+/**
+ * @brief Copy a caller's async options without any of the query options
+ *
+ * Used for the requests made on the way to the resource the caller asked for, such as the steps of a RedPath. select,
+ * filter, top, skip and maxMembers are cleared, nothing in dest needs to be freed.
+ *
+ * @param dest The options to fill in
+ * @param src The caller's options, may be NULL
+ * @return dest or NULL if src is NULL
+ */
+redfishAsyncOptions* odataQueryStripOptions(redfishAsyncOptions* dest, const redfishAsyncOptions* src);
+
+/**
+ * @brief Get the query options a service supports from its service root
+ *
+ * @param root The service root JSON
+ * @return The SERVICE_FEATURE_* bits from ProtocolFeaturesSupported
+ */
+unsigned int odataQueryFeaturesFromServiceRoot(json_t* root);
+
+/**
+ * @brief Decide which requested query options go to the service and which are applied locally
+ *
+ * @param features The SERVICE_FEATURE_* bits the service supports
+ * @param options The options for the request, may be NULL
+ * @param send Filled in with the query options to put on the URL, may be NULL
+ * @param local Filled in with the query options to apply to the response, may be NULL
+ */
+void odataQuerySplit(unsigned int features, const redfishAsyncOptions* options, unsigned int* send, unsigned int* local);
+
+/**
+ * @brief Build the URL encoded query string for a request
+ *
+ * @param uri The URI the query is for, used to decide between '?' and '&'
+ * @param options The options for the request
+ * @param send The query options to include
+ * @return A new string to append to the URI (possibly empty) or NULL on allocation failure
+ */
+char* odataQueryString(const char* uri, const redfishAsyncOptions* options, unsigned int send);
+
+/**
+ * @brief Build a $filter expression that matches at least the members a RedPath predicate matches
+ *
+ * RedPath values are untyped, so a value that could be a number, boolean or null is compared both as that and as a string.
+ *
+ * @param propName The property the predicate tests, '.' separates nested properties
+ * @param op The predicate operator
+ * @param value The value the property is compared to
+ * @return A new $filter expression or NULL if the predicate cannot be expressed as one
+ */
+char* odataFilterFromRedPath(const char* propName, RedPathOp op, const char* value);
+
+/**
+ * @brief Build the URI to read a collection with its members filtered and expanded one level
+ *
+ * @param uri The URI of the collection
+ * @param features The SERVICE_FEATURE_* bits the service supports
+ * @param filter A $filter expression to apply if the service supports $filter, may be NULL
+ * @return A new URI or NULL if the service supports neither query or on allocation failure
+ */
+char* odataCollectionUri(const char* uri, unsigned int features, const char* filter);
+
+/**
+ * @brief Apply query options to a response and then call the callback
+ *
+ * Members of a collection that are only links are fetched so $filter can be evaluated against them. The callback is
+ * always called, either before this returns or once all of the members have been obtained.
+ *
+ * @param payload The response, ownership passes to this function
+ * @param options The options for the request
+ * @param local The query options to apply
+ * @param httpCode The HTTP status of the response
+ * @param callback The callback to call with the result
+ * @param context The context for the callback
+ */
+void odataQueryApplyLocally(redfishPayload* payload, redfishAsyncOptions* options, unsigned int local, unsigned short httpCode, redfishAsyncCallback callback, void* context);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "pathMemo.h"
+
+#include "debug.h"
+#include "util.h"
+
+static char* getPathMemoKey(const char* fromUri, redPathNode* step);
+
+void setRedPathMemoLifetime(redfishService* service, unsigned int seconds)
+{
+    if(service == NULL)
+    {
+        return;
+    }
+    mutex_lock(&service->pathMemoLock);
+    json_decref(service->pathMemo);
+    service->pathMemo = NULL;
+    service->pathMemoLifetime = seconds;
+    if(seconds)
+    {
+        service->pathMemo = json_object();
+    }
+    mutex_unlock(&service->pathMemoLock);
+}
+
+void clearRedPathMemo(redfishService* service)
+{
+    if(service == NULL)
+    {
+        return;
+    }
+    mutex_lock(&service->pathMemoLock);
+    if(service->pathMemo)
+    {
+        json_object_clear(service->pathMemo);
+    }
+    mutex_unlock(&service->pathMemoLock);
+}
+
+bool pathMemoEnabled(redfishService* service)
+{
+    return (service != NULL && service->pathMemoLifetime != 0);
+}
+
+bool pathMemoStep(redPathNode* step)
+{
+    //Only steps that select a single resource by name or index can be replaced by its URI. The member at an index can change as
+    //members come and go, which the lifetime bounds, and a member that is gone returns 404 and is forgotten
+    return (step->isRoot == false && (step->nodeName != NULL || step->isIndex));
+}
+
+char* pathMemoLookup(redfishService* service, const char* fromUri, redPathNode* step)
+{
+    char* key;
+    json_t* entry;
+    char* ret = NULL;
+
+    if(pathMemoEnabled(service) == false || pathMemoStep(step) == false)
+    {
+        return NULL;
+    }
+    key = getPathMemoKey(fromUri, step);
+    if(key == NULL)
+    {
+        return NULL;
+    }
+    mutex_lock(&service->pathMemoLock);
+    entry = json_object_get(service->pathMemo, key);
+    if(entry)
+    {
+        if(json_integer_value(json_object_get(entry, "expires")) > (json_int_t)time(NULL))
+        {
+            ret = safeStrdup(json_string_value(json_object_get(entry, "uri")));
+        }
+        else
+        {
+            json_object_del(service->pathMemo, key);
+        }
+    }
+    mutex_unlock(&service->pathMemoLock);
+    free(key);
+    return ret;
+}
+
+void pathMemoRemember(redfishService* service, const char* fromUri, redPathNode* step, redfishPayload* payload)
+{
+    redfishPayload* id;
+    char* toUri;
+    char* key;
+
+    if(pathMemoEnabled(service) == false || payload == NULL || pathMemoStep(step) == false)
+    {
+        return;
+    }
+    id = getPayloadByNodeNameNoNetwork(payload, "@odata.id");
+    toUri = getPayloadStringValue(id);
+    cleanupPayload(id);
+    //Embedded objects have no URI of their own and fragments can't be requested directly
+    if(toUri == NULL || toUri[0] != '/' || strchr(toUri, '#') != NULL)
+    {
+        free(toUri);
+        return;
+    }
+    key = getPathMemoKey(fromUri, step);
+    if(key)
+    {
+        mutex_lock(&service->pathMemoLock);
+        if(service->pathMemo)
+        {
+            json_object_set_new(service->pathMemo, key, json_pack("{s:s,s:I}", "uri", toUri, "expires", (json_int_t)(time(NULL) + service->pathMemoLifetime)));
+        }
+        mutex_unlock(&service->pathMemoLock);
+        free(key);
+    }
+    free(toUri);
+}
+
+void pathMemoForget(redfishService* service, const char* uri)
+{
+    void* iter;
+    void* next;
+
+    if(pathMemoEnabled(service) == false)
+    {
+        return;
+    }
+    mutex_lock(&service->pathMemoLock);
+    iter = service->pathMemo ? json_object_iter(service->pathMemo) : NULL;
+    while(iter)
+    {
+        next = json_object_iter_next(service->pathMemo, iter);
+        if(strcmp(json_string_value(json_object_get(json_object_iter_value(iter), "uri")), uri) == 0)
+        {
+            json_object_del(service->pathMemo, json_object_iter_key(iter));
+        }
+        iter = next;
+    }
+    mutex_unlock(&service->pathMemoLock);
+}
+
+/*The URI a step was taken from and the name or [index] it selected, the URI is stored without any trailing '/' so the root matches either way*/
+static char* getPathMemoKey(const char* fromUri, redPathNode* step)
+{
+    char index[32];
+    const char* selected = step->nodeName;
+    size_t length;
+    size_t size;
+    char* ret;
+
+    if(fromUri == NULL || fromUri[0] != '/' || strchr(fromUri, '#') != NULL)
+    {
+        return NULL;
+    }
+    length = strlen(fromUri);
+    while(length > 1 && fromUri[length-1] == '/')
+    {
+        length--;
+    }
+    if(step->isIndex)
+    {
+        //Names can't contain '[', so an index never matches a name
+        snprintf(index, sizeof(index), "[%lu]", (unsigned long)step->index);
+        selected = index;
+    }
+    size = length + strlen(selected) + 2;
+    ret = (char*)malloc(size);
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    snprintf(ret, size, "%.*s\n%s", (int)length, fromUri, selected);
+    return ret;
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
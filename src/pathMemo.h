@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file pathMemo.h
+ * @brief File containing the interface for remembering RedPath steps.
+ *
+ * This file explains the interface for the per service memo of where RedPath steps lead, see setRedPathMemoLifetime().
+ */
+#ifndef _PATH_MEMO_H_
+#define _PATH_MEMO_H_
+
+#include "internal_service.h"
+#include <redfishPayload.h>
+
+/**
+ * @brief Check if the service remembers where RedPath steps lead
+ *
+ * @param service The service
+ * @return True if setRedPathMemoLifetime() has enabled the memo
+ */
+bool pathMemoEnabled(redfishService* service);
+
+/**
+ * @brief Check if a RedPath step can be remembered
+ *
+ * @param step The step
+ * @return True if the step selects a single resource by name or index
+ */
+bool pathMemoStep(redPathNode* step);
+
+/**
+ * @brief Find where a RedPath step led the last time it was taken
+ *
+ * @param service The service
+ * @param fromUri The URI of the resource the step is taken from
+ * @param step The step
+ * @return The URI of the resulting resource, which must be freed, or NULL if it is not known or has expired
+ */
+char* pathMemoLookup(redfishService* service, const char* fromUri, redPathNode* step);
+
+/**
+ * @brief Remember where a RedPath step led
+ *
+ * Nothing is remembered if the result is not a resource with a URI of its own.
+ *
+ * @param service The service
+ * @param fromUri The URI of the resource the step was taken from
+ * @param step The step
+ * @param payload The result of the step
+ */
+void pathMemoRemember(redfishService* service, const char* fromUri, redPathNode* step, redfishPayload* payload);
+
+/**
+ * @brief Forget every RedPath step that led to a URI
+ *
+ * @param service The service
+ * @param uri The URI that is no longer valid
+ */
+void pathMemoForget(redfishService* service, const char* uri);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
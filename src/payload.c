@@ -5,20 +5,148 @@
 //----------------------------------------------------------------------------
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
 
 #include "redfishPayload.h"
+#include "internal_payload.h"
+#include "internal_redpath.h"
+#include "jsonScan.h"
+#include "arena.h"
+#include "intern.h"
+#include "tape.h"
+#include "hash.h"
+#include "internal_service.h"
+#include "pathMemo.h"
+#include "odataQuery.h"
 #include "debug.h"
 #include "util.h"
 
-static redfishPayload* getOpResult(redfishPayload* payload, const char* propName, RedPathOp op, const char* value);
-static bool            getOpResultAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
-static redfishPayload* collectionEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value);
-static bool            collectionEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
-static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value);
-static bool            arrayEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+static redfishPayload* getOpResult(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue);
+static long long       getOpIntValue(redPathNode* redpath);
+static bool            getOpResultAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+static redfishPayload* collectionEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue);
+static bool            collectionEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+static bool            collectionMembersEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+static char*           getCollectionQueryUri(redfishPayload* payload, const char* propName, RedPathOp op, const char* value);
+static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue);
+static void            gotOpResultForQuery(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static bool            arrayEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+static void            opGotPayloadByIndexAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static void            gotStreamMemberAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static size_t          getMaxInFlight(redfishAsyncOptions* options);
 static redfishPayload* createCollection(redfishService* service, size_t count, redfishPayload** payloads);
 static json_t*         json_object_get_by_index(json_t* json, size_t index);
 static bool            isOdataIdNode(json_t* json, char** uriPtr);
+static bool            isUnparsedJson(redfishPayload* payload);
+static bool            getUnparsedMember(redfishPayload* payload, const char* name, bool isPath, json_t** value);
+static redfishPayload* createChildPayload(json_t* value, redfishPayload* parent);
+static bool            isFrozen(redfishPayload* payload);
+static bool            getFrozenMember(redfishPayload* payload, const char* name, bool isPath, size_t* node);
+static bool            frozenNodeNeedsJson(redfishPayload* payload, size_t node);
+static redfishPayload* createFrozenChildPayload(redfishPayload* parent, size_t node);
+static bool            sharePayloadContent(redfishPayload* payload);
+static void            releasePayloadContent(redfishPayload* payload);
+static bool            sharePayloadJson(redfishPayload* original, redfishPayload* copy);
+static bool            isPayloadJsonShared(redfishPayload* payload);
+static void            releasePayloadJson(redfishPayload* payload);
+static bool            makePayloadJsonPrivate(redfishPayload* payload);
+static json_t*         getObjectMemberByIndex(redfishPayload* payload, size_t index);
+static mutex*          getPayloadLock(redfishPayload* payload);
+static void*           loadPointer(void** pointer);
+static void            freeObjectIndex(redfishPayload* payload);
+static json_t*         jsonObjectGetSegment(json_t* object, const char* key, size_t keyLength);
+static bool            resolvePropertyPath(redfishPayload* payload, const redfishPropertyPath* path, json_t** json, size_t* node);
+
+/** Objects with fewer members than this are just walked when accessed by index **/
+#define OBJECT_INDEX_MIN_SIZE 16
+/** The number of locks shared by all payloads, see getPayloadLock() **/
+#define PAYLOAD_LOCK_COUNT 8
+
+/** Taken while a payload that other threads may be reading is parsed, thawed, or indexed **/
+static mutex gPayloadLocks[PAYLOAD_LOCK_COUNT] = {mutex_initializer, mutex_initializer, mutex_initializer, mutex_initializer,
+                                                  mutex_initializer, mutex_initializer, mutex_initializer, mutex_initializer};
+
+/** The number of payloads sharing the same raw content **/
+struct _payloadContentShare
+{
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 refCount;
+#else
+    LONG refCount;
+#endif
+#else
+    size_t refCount;
+#endif
+};
+
+/** The payloads sharing the same JSON tree through copyRedfishPayload() **/
+struct _payloadJsonShare
+{
+    /** The number of payloads (copies and their children) holding this structure **/
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 refCount;
+#else
+    LONG refCount;
+#endif
+#else
+    size_t refCount;
+#endif
+    /** The number of copies still using the tree, the tree may only be changed in place by the last one **/
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 copies;
+#else
+    LONG copies;
+#endif
+#else
+    size_t copies;
+#endif
+};
+
+/** The member names of an object in iteration order **/
+struct _payloadObjectIndex
+{
+    /** The object the index was built for **/
+    json_t* object;
+    /** The number of members the object had when the index was built **/
+    size_t count;
+    /** The member names, allocated in the same block as this structure **/
+    const char** keys;
+};
+
+/** One member name in a compiled property path **/
+typedef struct
+{
+    /** The NUL terminated member name **/
+    const char* name;
+    /** The length of name **/
+    size_t length;
+} propertyPathSegment;
+
+struct _redfishPropertyPath
+{
+    /** The path as originally given **/
+    const char* path;
+    /** The number of segments **/
+    size_t segmentCount;
+    /** The segments, the names are stored after them in the same block **/
+    propertyPathSegment* segments;
+};
+
+struct _redfishPayloadIterator
+{
+    /** The iterator's own reference to the payload being walked **/
+    redfishPayload* payload;
+    /** The jansson iterator for the next member of an object **/
+    void* iter;
+    /** The index of the next member **/
+    size_t index;
+};
 
 typedef struct
 {
@@ -45,19 +173,7 @@ json_t *json_object_get_by_path(json_t *object, const char *path)
 
     while (string_try_next(&str, delimiter))
     {
-
-// json_object_getn is only available with Jansson 2.14+.
-// Manually split the keys for compatibility with older versions
-#if JANSSON_VERSION_HEX >= 0x021400
-        out = json_object_getn(out, str.string, str.length);
-#else
-        char *sub_key = calloc(str.length + 1, sizeof(char));  // allocate dynamic memory for sub_key
-        memcpy(sub_key, str.string, str.length);
-        sub_key[str.length] = '\0';
-
-        out = json_object_get(out, (const char *)sub_key);
-        free(sub_key);
-#endif
+        out = jsonObjectGetSegment(out, str.string, str.length);
 
         if (out == NULL)
             return NULL;
@@ -101,6 +217,247 @@ redfishPayload* createRedfishPayload(json_t* value, redfishService* service)
     return payload;
 }
 
+redfishPayload* createDeferredRedfishPayload(char* content, size_t contentLength, redfishService* service)
+{
+    redfishPayload* payload;
+    payload = (redfishPayload*)calloc(sizeof(redfishPayload), 1);
+    if(payload == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to allocate payload!\n", __func__);
+        free(content);
+        return NULL;
+    }
+    //Leave json NULL, it will be filled in by getPayloadJson() if anyone ever asks for it
+    payload->content = content;
+    payload->contentLength = contentLength;
+    payload->service = service;
+    if(service)
+    {
+        serviceIncRef(service);
+    }
+    payload->contentType = PAYLOAD_CONTENT_JSON;
+    return payload;
+}
+
+redfishPayload* createFrozenRedfishPayload(payloadTape* tape, redfishService* service)
+{
+    redfishPayload* payload;
+    payload = (redfishPayload*)calloc(sizeof(redfishPayload), 1);
+    if(payload == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to allocate payload!\n", __func__);
+        tapeDecRef(tape);
+        return NULL;
+    }
+    payload->tape = tape;
+    payload->tapeNode = tapeRoot(tape);
+    payload->service = service;
+    if(service)
+    {
+        serviceIncRef(service);
+    }
+    payload->contentType = PAYLOAD_CONTENT_JSON;
+    return payload;
+}
+
+char* getPayloadNextLink(redfishPayload* payload)
+{
+    json_t* value;
+    size_t node;
+    char* ret;
+
+    if(!payload)
+    {
+        return NULL;
+    }
+    if(isFrozen(payload))
+    {
+        //Every response is checked for a next page, don't thaw the payload to do it
+        if(getFrozenMember(payload, "Members@odata.nextLink", false, &node))
+        {
+            return safeStrdup(tapeStringValue(payload->tape, node, NULL));
+        }
+        return NULL;
+    }
+    if(getUnparsedMember(payload, "Members@odata.nextLink", false, &value) == false)
+    {
+        return safeStrdup(json_string_value(json_object_get(getPayloadJson(payload), "Members@odata.nextLink")));
+    }
+    ret = safeStrdup(json_string_value(value));
+    json_decref(value);
+    return ret;
+}
+
+bool appendCollectionPage(redfishPayload* collection, redfishPayload* page, size_t maxMembers)
+{
+    json_t* json;
+    json_t* members;
+    json_t* pageMembers;
+    json_t* value;
+    size_t i;
+
+    if(makePayloadJsonPrivate(collection) == false)
+    {
+        return false;
+    }
+    freeObjectIndex(collection);
+    json = getPayloadJson(collection);
+    members = json_object_get(json, "Members");
+    if(!json_is_array(members))
+    {
+        return false;
+    }
+    if(page)
+    {
+        pageMembers = json_object_get(getPayloadJson(page), "Members");
+        json_array_foreach(pageMembers, i, value)
+        {
+            if(maxMembers && json_array_size(members) >= maxMembers)
+            {
+                break;
+            }
+            //Page JSON from an arena goes away with the page
+            json_array_append_new(members, (page->arena) ? json_deep_copy(value) : json_incref(value));
+        }
+        value = json_object_get(getPayloadJson(page), "Members@odata.nextLink");
+        if(value)
+        {
+            json_object_set(json, "Members@odata.nextLink", value);
+        }
+        else
+        {
+            json_object_del(json, "Members@odata.nextLink");
+        }
+    }
+    if(maxMembers && json_array_size(members) >= maxMembers)
+    {
+        while(json_array_size(members) > maxMembers)
+        {
+            json_array_remove(members, json_array_size(members) - 1);
+        }
+        json_object_del(json, "Members@odata.nextLink");
+    }
+    return true;
+}
+
+json_t* getPayloadJson(redfishPayload* payload)
+{
+    json_error_t err;
+    payloadArena* previousArena;
+    json_t* json;
+    mutex* lock;
+
+    if(!payload)
+    {
+        return NULL;
+    }
+    json = (json_t*)loadPointer((void**)&(payload->json));
+    if(json != NULL || (isUnparsedJson(payload) == false && isFrozen(payload) == false))
+    {
+        return json;
+    }
+    //Any number of threads may be reading the payload, only one of them parses or thaws it. The content and the tape stay
+    //until the payload is cleaned up since the others may still be scanning them
+    lock = getPayloadLock(payload);
+    mutex_lock(lock);
+    if(isUnparsedJson(payload))
+    {
+        //If the payload has an arena the whole tree comes from it, otherwise this is a no-op
+        previousArena = arenaSetCurrent(payload->arena);
+        json = json_loadb(payload->content, payload->contentLength, 0, &err);
+        if(json == NULL)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to parse deferred json! %s\n", __func__, err.text);
+            //Only parse once, even if it failed. The text is still there for getPayloadBody()
+            payload->contentTypeStr = safeStrdup("application/json");
+            payload->contentType = PAYLOAD_CONTENT_OTHER;
+        }
+        else if(payload->arena)
+        {
+            //Arena JSON is read only (it is copied before any change), so it is safe to share values with other payloads
+            internJsonValues(json);
+        }
+        arenaSetCurrent(previousArena);
+        cas(&(payload->json), NULL, json);
+    }
+    else if(isFrozen(payload))
+    {
+        //Thaw the payload, it is going to be used (and maybe changed) as JSON from now on
+        json = tapeToJson(payload->tape, payload->tapeNode);
+        if(json == NULL)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to rebuild json from tape!\n", __func__);
+        }
+        cas(&(payload->json), NULL, json);
+    }
+    mutex_unlock(lock);
+    return payload->json;
+}
+
+bool freezePayload(redfishPayload* payload)
+{
+    json_t* json;
+    payloadTape* tape;
+
+    if(!payload || payload->contentType != PAYLOAD_CONTENT_JSON)
+    {
+        return false;
+    }
+    if(isFrozen(payload))
+    {
+        return true;
+    }
+    json = getPayloadJson(payload);
+    if(json == NULL)
+    {
+        return false;
+    }
+    tape = tapeCreateFromJson(json);
+    if(tape == NULL)
+    {
+        return false;
+    }
+    if(!arenaContains(payload->arena, json))
+    {
+        json_decref(json);
+    }
+    arenaDecRef(payload->arena);
+    payload->arena = NULL;
+    payload->json = NULL;
+    releasePayloadJson(payload);
+    //Anything left from before the JSON was parsed or thawed would be mistaken for the current form
+    releasePayloadContent(payload);
+    tapeDecRef(payload->tape);
+    payload->tape = tape;
+    payload->tapeNode = tapeRoot(tape);
+    return true;
+}
+
+uint64_t getPayloadHash(redfishPayload* payload, const char** ignoreProperties)
+{
+    json_t* json;
+
+    if(payload == NULL)
+    {
+        return 0;
+    }
+    if(payload->contentType != PAYLOAD_CONTENT_JSON)
+    {
+        return hashString(payload->content, payload->contentLength);
+    }
+    if(isFrozen(payload))
+    {
+        //Don't thaw the payload just to read it
+        return tapeHash(payload->tape, payload->tapeNode, ignoreProperties);
+    }
+    json = getPayloadJson(payload);
+    if(json == NULL)
+    {
+        return 0;
+    }
+    return jsonHash(json, ignoreProperties);
+}
+
 redfishPayload* createRedfishPayloadFromString(const char* value, redfishService* service)
 {
     json_error_t err;
@@ -175,7 +532,21 @@ redfishPayload* copyRedfishPayload(const redfishPayload* original)
     }
     if(original->json)
     {
-        ret->json = json_deep_copy(original->json);
+        //Share the tree, setPayloadElementByName() makes a private copy if either payload is ever changed
+        if(sharePayloadJson((redfishPayload*)original, ret))
+        {
+            ret->json = original->json;
+            ret->arena = arenaIncRef(original->arena);
+            //Only a tree parsed into the arena belongs to it, a collection built from other payloads is on the heap
+            if(!arenaContains(original->arena, original->json))
+            {
+                json_incref(ret->json);
+            }
+        }
+        else
+        {
+            ret->json = json_deep_copy(original->json);
+        }
     }
     if(original->service)
     {
@@ -183,14 +554,35 @@ redfishPayload* copyRedfishPayload(const redfishPayload* original)
     }
     if(original->content)
     {
-        ret->contentLength = original->contentLength;
-        ret->content = (char*)malloc(ret->contentLength);
-        if(ret->content == NULL)
+        //The content is never written to, only freed, so it just needs a count of who is using it
+        if(sharePayloadContent((redfishPayload*)original))
         {
-            free(ret);
-            return NULL;
+            ret->content = original->content;
+            ret->contentShare = original->contentShare;
+        }
+        else
+        {
+            ret->content = (char*)malloc(original->contentLength);
+            if(ret->content == NULL)
+            {
+                if(!arenaContains(ret->arena, ret->json))
+                {
+                    json_decref(ret->json);
+                }
+                arenaDecRef(ret->arena);
+                releasePayloadJson(ret);
+                free(ret);
+                return NULL;
+            }
+            memcpy(ret->content, original->content, original->contentLength);
         }
-        memcpy(ret->content, original->content, ret->contentLength);
+        ret->contentLength = original->contentLength;
+    }
+    if(original->tape)
+    {
+        //Tapes are never modified so the copy can share it
+        ret->tape = tapeIncRef(original->tape);
+        ret->tapeNode = original->tapeNode;
     }
     ret->contentType = original->contentType;
     ret->contentTypeStr = safeStrdup(original->contentTypeStr);
@@ -205,13 +597,32 @@ bool isPayloadCollection(redfishPayload* payload)
 {
     json_t* members;
     json_t* count;
+    jsonSpan span;
+    size_t node;
 
-    if(!payload || !json_is_object(payload->json))
+    if(isFrozen(payload))
+    {
+        return getFrozenMember(payload, "Members@odata.count", false, &node);
+    }
+    if(isUnparsedJson(payload))
+    {
+        //Only the presence of the count matters, so there is no need to parse anything
+        switch(jsonScanObjectMember(payload->content, payload->contentLength, "Members@odata.count", 19, &span))
+        {
+            case JSONSCAN_FOUND:
+                return true;
+            case JSONSCAN_NOT_FOUND:
+                return false;
+            default:
+                break;
+        }
+    }
+    if(!payload || !json_is_object(getPayloadJson(payload)))
     {
         return false;
     }
-    members = json_object_get(payload->json, "Members");
-    count = json_object_get(payload->json, "Members@odata.count");
+    members = json_object_get(getPayloadJson(payload), "Members");
+    count = json_object_get(getPayloadJson(payload), "Members@odata.count");
     if(count != NULL)
     {
         //Workaround bug in some implementations where they have a count of 0 and no Members element
@@ -222,7 +633,15 @@ bool isPayloadCollection(redfishPayload* payload)
 
 bool isPayloadArray(redfishPayload* payload)
 {
-    if(!payload || !json_is_array(payload->json))
+    if(isFrozen(payload))
+    {
+        return (tapeType(payload->tape, payload->tapeNode) == JSON_ARRAY);
+    }
+    if(isUnparsedJson(payload) && jsonScanValidate(payload->content, payload->contentLength))
+    {
+        return (jsonScanFirstChar(payload->content, payload->contentLength) == '[');
+    }
+    if(!payload || !json_is_array(getPayloadJson(payload)))
     {
         return false;
     }
@@ -233,8 +652,9 @@ size_t getPayloadSize(redfishPayload* payload)
 {
     char* body;
     size_t len;
-    if(payload->contentType != PAYLOAD_CONTENT_JSON)
+    if(payload->contentType != PAYLOAD_CONTENT_JSON || (payload->json == NULL && payload->content != NULL))
     {
+        //Either not JSON or JSON that hasn't been parsed yet, the raw length is correct either way
         return payload->contentLength;
     }
     body = payloadToString(payload, false);
@@ -245,10 +665,22 @@ size_t getPayloadSize(redfishPayload* payload)
 
 char* getPayloadBody(redfishPayload* payload)
 {
+    char* ret;
     if(payload->contentType != PAYLOAD_CONTENT_JSON)
     {
         return payload->content;
     }
+    if(payload->json == NULL && payload->content != NULL)
+    {
+        //Unparsed JSON, hand back a copy of the raw text instead of parsing just to dump it again
+        ret = malloc(payload->contentLength+1);
+        if(ret)
+        {
+            memcpy(ret, payload->content, payload->contentLength);
+            ret[payload->contentLength] = 0;
+        }
+        return ret;
+    }
     return payloadToString(payload, false);
 }
 
@@ -264,16 +696,39 @@ char* getPayloadContentType(redfishPayload* payload)
 char* getPayloadUri(redfishPayload* payload)
 {
     json_t* json;
+    size_t node;
+
+    char* ret;
 
     if(!payload)
     {
         return NULL;
     }
 
-    json = json_object_get(payload->json, "@odata.id");
+    if(isFrozen(payload))
+    {
+        if(getFrozenMember(payload, "@odata.id", false, &node) || getFrozenMember(payload, "target", false, &node))
+        {
+            return safeStrdup(tapeStringValue(payload->tape, node, NULL));
+        }
+        return NULL;
+    }
+
+    if(getUnparsedMember(payload, "@odata.id", false, &json))
+    {
+        if(json == NULL && getUnparsedMember(payload, "target", false, &json) == false)
+        {
+            json = json_incref(json_object_get(getPayloadJson(payload), "target"));
+        }
+        ret = safeStrdup(json_string_value(json));
+        json_decref(json);
+        return ret;
+    }
+
+    json = json_object_get(getPayloadJson(payload), "@odata.id");
     if(json == NULL)
     {
-        json = json_object_get(payload->json, "target");
+        json = json_object_get(getPayloadJson(payload), "target");
         if(json == NULL)
         {
             return NULL;
@@ -285,12 +740,24 @@ char* getPayloadUri(redfishPayload* payload)
 char* getPayloadStringValue(redfishPayload* payload)
 {
     json_t* tmp;
-    const char* value = json_string_value(payload->json);
+    const char* value;
+    size_t node;
+
+    if(isFrozen(payload))
+    {
+        node = payload->tapeNode;
+        if(tapeType(payload->tape, node) == JSON_OBJECT && tapeSize(payload->tape, node) == 1)
+        {
+            tapeGetByIndex(payload->tape, node, 0, NULL, &node);
+        }
+        return safeStrdup(tapeStringValue(payload->tape, node, NULL));
+    }
+    value = json_string_value(getPayloadJson(payload));
     if(value == NULL)
     {
-        if(json_object_size(payload->json) == 1)
+        if(json_object_size(getPayloadJson(payload)) == 1)
         {
-            tmp = json_object_get_by_index(payload->json, 0);
+            tmp = json_object_get_by_index(getPayloadJson(payload), 0);
             if(tmp != NULL)
             {
                 value = json_string_value(tmp);
@@ -306,27 +773,49 @@ char* getPayloadStringValue(redfishPayload* payload)
 
 int getPayloadIntValue(redfishPayload* payload)
 {
-    return (int)json_integer_value(payload->json);
+    return (int)getPayloadLongLongValue(payload);
 }
 
 json_int_t getPayloadLongLongValue(redfishPayload* payload)
 {
-    return json_integer_value(payload->json);
+    if(isFrozen(payload))
+    {
+        return tapeIntegerValue(payload->tape, payload->tapeNode);
+    }
+    return json_integer_value(getPayloadJson(payload));
 }
 
 bool getPayloadBoolValue(redfishPayload* payload, bool* is_boolean) {
+  json_type type;
+
+  if(isFrozen(payload))
+  {
+      type = tapeType(payload->tape, payload->tapeNode);
+      if (is_boolean != NULL) {
+        *is_boolean = (type == JSON_TRUE || type == JSON_FALSE);
+      }
+      return (type == JSON_TRUE);
+  }
   if (is_boolean != NULL) {
-    *is_boolean = json_is_boolean(payload->json);
+    *is_boolean = json_is_boolean(getPayloadJson(payload));
   }
-  return json_boolean_value(payload->json);
+  return json_boolean_value(getPayloadJson(payload));
 }
 
 double getPayloadDoubleValue(redfishPayload* payload, bool* is_double) {
+    if(isFrozen(payload))
+    {
+        if (is_double != NULL)
+        {
+          *is_double = (tapeType(payload->tape, payload->tapeNode) == JSON_REAL);
+        }
+        return tapeRealValue(payload->tape, payload->tapeNode);
+    }
     if (is_double != NULL)
     {
-      *is_double = json_is_real(payload->json);
+      *is_double = json_is_real(getPayloadJson(payload));
     }
-    return json_real_value(payload->json);
+    return json_real_value(getPayloadJson(payload));
 }
 
 redfishPayload* getPayloadByNodeName(redfishPayload* payload, const char* nodeName)
@@ -334,18 +823,33 @@ redfishPayload* getPayloadByNodeName(redfishPayload* payload, const char* nodeNa
     json_t* value;
     json_t* odataId;
     const char* uri;
+    size_t node;
 
     if(!payload || !nodeName)
     {
         return NULL;
     }
 
-    value = json_object_get_by_path(payload->json, nodeName);
+    if(isFrozen(payload))
+    {
+        if(getFrozenMember(payload, nodeName, true, &node) == false)
+        {
+            return NULL;
+        }
+        if(frozenNodeNeedsJson(payload, node) == false)
+        {
+            return createFrozenChildPayload(payload, node);
+        }
+        value = tapeToJson(payload->tape, node);
+    }
+    else if(getUnparsedMember(payload, nodeName, true, &value) == false)
+    {
+        value = json_incref(json_object_get_by_path(getPayloadJson(payload), nodeName));
+    }
     if(value == NULL)
     {
         return NULL;
     }
-    json_incref(value);
     if(json_object_size(value) == 1)
     {
         odataId = json_object_get(value, "@odata.id");
@@ -369,25 +873,40 @@ redfishPayload* getPayloadByNodeName(redfishPayload* payload, const char* nodeNa
         json_decref(value);
         value = odataId;
     }
-    return createRedfishPayload(value, payload->service);
+    return createChildPayload(value, payload);
 }
 
 redfishPayload* getPayloadByNodeNameNoNetwork(redfishPayload* payload, const char* nodeName)
 {
     json_t* value;
     json_t* odataId;
+    size_t node;
 
     if(!payload || !nodeName)
     {
         return NULL;
     }
 
-    value = json_object_get(payload->json, nodeName);
+    if(isFrozen(payload))
+    {
+        if(getFrozenMember(payload, nodeName, false, &node) == false)
+        {
+            return NULL;
+        }
+        if(tapeType(payload->tape, node) != JSON_STRING)
+        {
+            return createFrozenChildPayload(payload, node);
+        }
+        value = tapeToJson(payload->tape, node);
+    }
+    else if(getUnparsedMember(payload, nodeName, false, &value) == false)
+    {
+        value = json_incref(json_object_get(getPayloadJson(payload), nodeName));
+    }
     if(value == NULL)
     {
         return NULL;
     }
-    json_incref(value);
     if(json_is_string(value))
     {
         odataId = json_object();
@@ -395,7 +914,7 @@ redfishPayload* getPayloadByNodeNameNoNetwork(redfishPayload* payload, const cha
         json_decref(value);
         value = odataId;
     }
-    return createRedfishPayload(value, payload->service);
+    return createChildPayload(value, payload);
 }
 
 redfishPayload* getPayloadByIndex(redfishPayload* payload, size_t index)
@@ -403,6 +922,7 @@ redfishPayload* getPayloadByIndex(redfishPayload* payload, size_t index)
     json_t* value = NULL;
     json_t* odataId;
     const char* uri;
+    size_t node;
 
     if(!payload)
     {
@@ -415,13 +935,25 @@ redfishPayload* getPayloadByIndex(redfishPayload* payload, size_t index)
         cleanupPayload(members);
         return ret;
     }
-    if(json_is_array(payload->json))
+    if(isFrozen(payload))
     {
-        value = json_array_get(payload->json, index);
-    }
-    else if(json_is_object(payload->json))
+        if(tapeGetByIndex(payload->tape, payload->tapeNode, index, NULL, &node) == false)
+        {
+            return NULL;
+        }
+        if(frozenNodeNeedsJson(payload, node) == false)
+        {
+            return createFrozenChildPayload(payload, node);
+        }
+        value = tapeToJson(payload->tape, node);
+    }
+    else if(json_is_array(getPayloadJson(payload)))
+    {
+        value = json_incref(json_array_get(getPayloadJson(payload), index));
+    }
+    else if(json_is_object(getPayloadJson(payload)))
     {
-        value = json_object_get_by_index(payload->json, index);
+        value = json_incref(getObjectMemberByIndex(payload, index));
     }
 
     if(value == NULL)
@@ -429,27 +961,29 @@ redfishPayload* getPayloadByIndex(redfishPayload* payload, size_t index)
         return NULL;
     }
 
-    json_incref(value);
     if(json_object_size(value) == 1)
     {
         odataId = json_object_get(value, "@odata.id");
         if(odataId != NULL)
         {
+            json_incref(odataId);
             uri = json_string_value(odataId);
             json_decref(value);
             value = getUriFromService(payload->service, uri);
+            json_decref(odataId);
             if(value == NULL)
             {
                 return NULL;
             }
         }
     }
-    return createRedfishPayload(value, payload->service);
+    return createChildPayload(value, payload);
 }
 
 redfishPayload* getPayloadByIndexNoNetwork(redfishPayload* payload, size_t index)
 {
     json_t* value = NULL;
+    size_t node;
 
     if(!payload)
     {
@@ -462,13 +996,21 @@ redfishPayload* getPayloadByIndexNoNetwork(redfishPayload* payload, size_t index
         cleanupPayload(members);
         return ret;
     }
-    if(json_is_array(payload->json))
+    if(isFrozen(payload))
     {
-        value = json_array_get(payload->json, index);
+        if(tapeGetByIndex(payload->tape, payload->tapeNode, index, NULL, &node) == false)
+        {
+            return NULL;
+        }
+        return createFrozenChildPayload(payload, node);
     }
-    else if(json_is_object(payload->json))
+    if(json_is_array(getPayloadJson(payload)))
     {
-        value = json_object_get_by_index(payload->json, index);
+        value = json_array_get(getPayloadJson(payload), index);
+    }
+    else if(json_is_object(getPayloadJson(payload)))
+    {
+        value = getObjectMemberByIndex(payload, index);
     }
 
     if(value == NULL)
@@ -477,7 +1019,7 @@ redfishPayload* getPayloadByIndexNoNetwork(redfishPayload* payload, size_t index
     }
 
     json_incref(value);
-    return createRedfishPayload(value, payload->service);
+    return createChildPayload(value, payload);
 }
 
 size_t getValueCountFromPayload(redfishPayload* payload)
@@ -486,13 +1028,24 @@ size_t getValueCountFromPayload(redfishPayload* payload)
     {
         return 0;
     }
-    if(json_is_array(payload->json))
+    if(isFrozen(payload))
+    {
+        switch(tapeType(payload->tape, payload->tapeNode))
+        {
+            case JSON_ARRAY:
+            case JSON_OBJECT:
+                return tapeSize(payload->tape, payload->tapeNode);
+            default:
+                return 1;
+        }
+    }
+    if(json_is_array(getPayloadJson(payload)))
     {
-        return json_array_size(payload->json);
+        return json_array_size(getPayloadJson(payload));
     }
-    else if(json_is_object(payload->json))
+    else if(json_is_object(getPayloadJson(payload)))
     {
-        return json_object_size(payload->json);
+        return json_object_size(getPayloadJson(payload));
     }
     else
     {
@@ -500,6 +1053,109 @@ size_t getValueCountFromPayload(redfishPayload* payload)
     }
 }
 
+redfishPayloadIterator* createPayloadIterator(redfishPayload* payload)
+{
+    redfishPayloadIterator* ret;
+    redfishPayload* target;
+
+    if(!payload)
+    {
+        return NULL;
+    }
+    if(isPayloadCollection(payload))
+    {
+        target = getPayloadByNodeNameNoNetwork(payload, "Members");
+    }
+    else
+    {
+        if(!isFrozen(payload))
+        {
+            //Parse before copying so the iterator shares the tree instead of parsing the content a second time
+            getPayloadJson(payload);
+        }
+        target = copyRedfishPayload(payload);
+    }
+    if(target == NULL)
+    {
+        return NULL;
+    }
+    if(isFrozen(target) == false && !json_is_object(target->json) && !json_is_array(target->json))
+    {
+        cleanupPayload(target);
+        return NULL;
+    }
+    if(isFrozen(target) && tapeType(target->tape, target->tapeNode) != JSON_OBJECT && tapeType(target->tape, target->tapeNode) != JSON_ARRAY)
+    {
+        cleanupPayload(target);
+        return NULL;
+    }
+    ret = (redfishPayloadIterator*)calloc(1, sizeof(redfishPayloadIterator));
+    if(ret == NULL)
+    {
+        cleanupPayload(target);
+        return NULL;
+    }
+    ret->payload = target;
+    return ret;
+}
+
+bool payloadIteratorNext(redfishPayloadIterator* iterator, const char** key, redfishPayload** value)
+{
+    redfishPayload* payload;
+    json_t* json;
+    const char* myKey = NULL;
+    size_t node;
+
+    if(!iterator || !value)
+    {
+        return false;
+    }
+    payload = iterator->payload;
+    if(isFrozen(payload))
+    {
+        if(tapeGetByIndex(payload->tape, payload->tapeNode, iterator->index, &myKey, &node) == false)
+        {
+            return false;
+        }
+        *value = createFrozenChildPayload(payload, node);
+    }
+    else if(json_is_object(payload->json))
+    {
+        iterator->iter = (iterator->index == 0) ? json_object_iter(payload->json) : json_object_iter_next(payload->json, iterator->iter);
+        if(iterator->iter == NULL)
+        {
+            return false;
+        }
+        myKey = json_object_iter_key(iterator->iter);
+        *value = createChildPayload(json_incref(json_object_iter_value(iterator->iter)), payload);
+    }
+    else
+    {
+        json = json_array_get(payload->json, iterator->index);
+        if(json == NULL)
+        {
+            return false;
+        }
+        *value = createChildPayload(json_incref(json), payload);
+    }
+    iterator->index++;
+    if(key)
+    {
+        *key = myKey;
+    }
+    return (*value != NULL);
+}
+
+void cleanupPayloadIterator(redfishPayloadIterator* iterator)
+{
+    if(!iterator)
+    {
+        return;
+    }
+    cleanupPayload(iterator->payload);
+    free(iterator);
+}
+
 redfishPayload* getPayloadForPath(redfishPayload* payload, redPathNode* redpath)
 {
     redfishPayload* ret = NULL;
@@ -520,7 +1176,7 @@ redfishPayload* getPayloadForPath(redfishPayload* payload, redPathNode* redpath)
     }
     else
     {
-        ret = getOpResult(payload, redpath->propName, redpath->op, redpath->value);
+        ret = getOpResult(payload, redpath->propName, redpath->op, redpath->value, getOpIntValue(redpath));
     }
 
     if(redpath->next == NULL || ret == NULL)
@@ -537,35 +1193,172 @@ redfishPayload* getPayloadForPath(redfishPayload* payload, redPathNode* redpath)
 
 redfishPayload* getPayloadForPathString(redfishPayload* payload, const char* string)
 {
-    redPathNode* redpath;
+    redPathPlan* plan;
     redfishPayload* ret;
 
     if(!string)
     {
         return NULL;
     }
-    redpath = parseRedPath(string);
-    if(redpath == NULL)
+    plan = redpathPlanGet(string);
+    if(plan == NULL)
     {
         REDFISH_DEBUG_ERR_PRINT("%s: Unable to parse redpath %s!", __func__, string);
         return NULL;
     }
-    ret = getPayloadForPath(payload, redpath);
-    cleanupRedPath(redpath);
+    ret = getPayloadForPath(payload, redpathPlanNodes(plan));
+    redpathPlanDecRef(plan);
+    return ret;
+}
+
+redfishPropertyPath* compilePropertyPath(const char* path)
+{
+    redfishPropertyPath* ret;
+    string_t str;
+    size_t count = 0;
+    size_t pathLength;
+    char* names;
+
+    if(!path)
+    {
+        return NULL;
+    }
+    pathLength = strlen(path);
+    str.string = path;
+    str.length = 0;
+    while(string_try_next(&str, "."))
+    {
+        count++;
+        str.string += str.length;
+    }
+    if(count == 0)
+    {
+        return NULL;
+    }
+    //Everything in one block: the structure, the segments, each name with its terminator, and the original path
+    ret = (redfishPropertyPath*)malloc(sizeof(redfishPropertyPath) + count*sizeof(propertyPathSegment) + (pathLength+1)*2);
+    if(ret == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to allocate property path!\n", __func__);
+        return NULL;
+    }
+    ret->segments = (propertyPathSegment*)(ret+1);
+    ret->segmentCount = count;
+    names = (char*)(ret->segments + count);
+    memcpy(names, path, pathLength+1);
+    ret->path = names;
+    names += pathLength+1;
+    str.string = path;
+    str.length = 0;
+    count = 0;
+    while(string_try_next(&str, "."))
+    {
+        memcpy(names, str.string, str.length);
+        names[str.length] = 0;
+        ret->segments[count].name = names;
+        ret->segments[count].length = str.length;
+        count++;
+        names += str.length+1;
+        str.string += str.length;
+    }
     return ret;
 }
 
+void cleanupPropertyPath(redfishPropertyPath* path)
+{
+    free(path);
+}
+
+redfishPayload* getPayloadByPropertyPath(redfishPayload* payload, const redfishPropertyPath* path)
+{
+    json_t* json;
+    size_t node;
+
+    if(!payload || !path)
+    {
+        return NULL;
+    }
+    if(getUnparsedMember(payload, path->path, true, &json))
+    {
+        if(json == NULL)
+        {
+            return NULL;
+        }
+        return createChildPayload(json, payload);
+    }
+    if(resolvePropertyPath(payload, path, &json, &node) == false)
+    {
+        return NULL;
+    }
+    if(isFrozen(payload))
+    {
+        return createFrozenChildPayload(payload, node);
+    }
+    return createChildPayload(json_incref(json), payload);
+}
+
+const char* getPayloadStringByPropertyPath(redfishPayload* payload, const redfishPropertyPath* path)
+{
+    json_t* json;
+    size_t node;
+
+    if(resolvePropertyPath(payload, path, &json, &node) == false)
+    {
+        return NULL;
+    }
+    if(isFrozen(payload))
+    {
+        return tapeStringValue(payload->tape, node, NULL);
+    }
+    return json_string_value(json);
+}
+
+bool getPayloadIntByPropertyPath(redfishPayload* payload, const redfishPropertyPath* path, json_int_t* value)
+{
+    json_t* json;
+    size_t node;
+
+    if(!value || resolvePropertyPath(payload, path, &json, &node) == false)
+    {
+        return false;
+    }
+    if(isFrozen(payload))
+    {
+        if(tapeType(payload->tape, node) != JSON_INTEGER)
+        {
+            return false;
+        }
+        *value = tapeIntegerValue(payload->tape, node);
+        return true;
+    }
+    if(!json_is_integer(json))
+    {
+        return false;
+    }
+    *value = json_integer_value(json);
+    return true;
+}
+
 size_t getCollectionSize(redfishPayload* payload)
 {
     json_t* members;
     json_t* count;
+    size_t node;
 
-    if(!payload || !json_is_object(payload->json))
+    if(isFrozen(payload))
+    {
+        if(!getFrozenMember(payload, "Members", false, &node) || !getFrozenMember(payload, "Members@odata.count", false, &node))
+        {
+            return 0;
+        }
+        return (size_t)tapeIntegerValue(payload->tape, node);
+    }
+    if(!payload || !json_is_object(getPayloadJson(payload)))
     {
         return 0;
     }
-    members = json_object_get(payload->json, "Members");
-    count = json_object_get(payload->json, "Members@odata.count");
+    members = json_object_get(getPayloadJson(payload), "Members");
+    count = json_object_get(getPayloadJson(payload), "Members@odata.count");
     if(!members || !count)
     {
         return 0;
@@ -575,17 +1368,27 @@ size_t getCollectionSize(redfishPayload* payload)
 
 size_t getArraySize(redfishPayload *payload)
 {
-    if(!payload || !json_is_array(payload->json))
+    if(isFrozen(payload))
+    {
+        return (tapeType(payload->tape, payload->tapeNode) == JSON_ARRAY) ? tapeSize(payload->tape, payload->tapeNode) : 0;
+    }
+    if(!payload || !json_is_array(getPayloadJson(payload)))
     {
         return 0;
     }
-    return json_array_size(payload->json);
+    return json_array_size(getPayloadJson(payload));
 }
 
 bool setPayloadElementByName(redfishPayload* payload, const char* name, json_t* element)
 {
     int rc;
-    rc = json_object_set(payload->json, name, element);
+
+    if(makePayloadJsonPrivate(payload) == false)
+    {
+        return false;
+    }
+    freeObjectIndex(payload);
+    rc = json_object_set(getPayloadJson(payload), name, element);
     return (rc == 0);
 }
 
@@ -669,7 +1472,7 @@ redfishPayload* postPayload(redfishPayload* target, redfishPayload* payload)
         return NULL;
     }
 
-    if(!json_is_object(payload->json))
+    if(!json_is_object(getPayloadJson(payload)))
     {
         return NULL;
     }
@@ -704,15 +1507,20 @@ void cleanupPayload(redfishPayload* payload)
     {
         return;
     }
-    json_decref(payload->json);
-    if(payload->contentTypeStr)
+    //JSON parsed into an arena isn't freed node by node, the arena takes all of it at once
+    if(!arenaContains(payload->arena, payload->json))
     {
-        free(payload->contentTypeStr);
+        json_decref(payload->json);
     }
-    if(payload->content)
+    arenaDecRef(payload->arena);
+    releasePayloadJson(payload);
+    tapeDecRef(payload->tape);
+    freeObjectIndex(payload);
+    if(payload->contentTypeStr)
     {
-        free(payload->content);
+        free(payload->contentTypeStr);
     }
+    releasePayloadContent(payload);
     if(payload->service)
     {
         serviceDecRef(payload->service);
@@ -723,6 +1531,8 @@ void cleanupPayload(redfishPayload* payload)
 char* payloadToString(redfishPayload* payload, bool prettyPrint)
 {
     size_t flags = 0;
+    json_t* json;
+    char* ret;
 	if(!payload)
     {
         return NULL;
@@ -731,24 +1541,30 @@ char* payloadToString(redfishPayload* payload, bool prettyPrint)
     {
         flags = JSON_INDENT(2);
     }
-    return json_dumps(payload->json, flags);
+    if(isFrozen(payload))
+    {
+        //Don't thaw the payload just to print it, other threads may be reading the tape
+        json = tapeToJson(payload->tape, payload->tapeNode);
+        ret = json_dumps(json, flags);
+        json_decref(json);
+        return ret;
+    }
+    return json_dumps(getPayloadJson(payload), flags);
 }
 
 static json_t* getEmbeddedJsonField(json_t* parent, const char* nodeName)
 {
     json_t* ret;
-    char* tmpStr;
-    char* tmpStr2;
+    const char* end;
 
-    tmpStr = getStringTill(nodeName, ".", &tmpStr2);
-    ret = json_object_get(parent, tmpStr);
-    free(tmpStr);
-    if(tmpStr2 != NULL)
+    end = strchr(nodeName, '.');
+    if(end == NULL)
     {
-        //Keep going...
-        return getEmbeddedJsonField(ret, tmpStr2+1);
+        return json_object_get(parent, nodeName);
     }
-    return ret;
+    ret = jsonObjectGetSegment(parent, nodeName, (size_t)(end-nodeName));
+    //Keep going...
+    return getEmbeddedJsonField(ret, end+1);
 }
 
 bool getPayloadByNodeNameAsync(redfishPayload* payload, const char* nodeName, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
@@ -764,18 +1580,54 @@ bool getPayloadByNodeNameAsync(redfishPayload* payload, const char* nodeName, re
     size_t size;
     redfishPayload* retPayload;
     bool haveUniqReference = false;
+    json_t* json;
+    json_t* thawed = NULL;
+    size_t node;
 
     if(!payload || !nodeName)
     {
         return false;
     }
 
-    value = json_object_get(payload->json, nodeName);
+    if(isFrozen(payload))
+    {
+        value = NULL;
+        //Members of collections and arrays never have dotted names, so trying the path here keeps the tape intact
+        if(getFrozenMember(payload, nodeName, false, &node) || (strchr(nodeName, '.') && getFrozenMember(payload, nodeName, true, &node)))
+        {
+            if(frozenNodeNeedsJson(payload, node) == false)
+            {
+                retPayload = createFrozenChildPayload(payload, node);
+                callback(true, 200, retPayload, context);
+                return true;
+            }
+            value = tapeToJson(payload->tape, node);
+            haveUniqReference = (value != NULL);
+        }
+    }
+    else if(getUnparsedMember(payload, nodeName, false, &value))
+    {
+        haveUniqReference = (value != NULL);
+    }
+    else
+    {
+        value = json_object_get(getPayloadJson(payload), nodeName);
+    }
     if(value == NULL)
     {
+        if(isFrozen(payload))
+        {
+            //Work on a private copy, the tape may be shared with other threads
+            thawed = tapeToJson(payload->tape, payload->tapeNode);
+            json = thawed;
+        }
+        else
+        {
+            json = getPayloadJson(payload);
+        }
         if(isPayloadCollection(payload))
         {
-            members = json_object_get(payload->json, "Members");
+            members = json_object_get(json, "Members");
             if(members)
             {
                 value = json_array();
@@ -811,11 +1663,11 @@ bool getPayloadByNodeNameAsync(redfishPayload* payload, const char* nodeName, re
         }
         else if(isPayloadArray(payload))
         {
-            size = json_array_size(payload->json);
+            size = json_array_size(json);
             value = json_array();
             for(i = 0; i < size; i++)
             {
-                member = json_array_get(payload->json, i);
+                member = json_array_get(json, i);
                 if(member)
                 {
                     tmp = json_object_get(member, nodeName);
@@ -840,8 +1692,17 @@ bool getPayloadByNodeNameAsync(redfishPayload* payload, const char* nodeName, re
         }
         else if(strchr(nodeName, '.'))
         {
-            value = getEmbeddedJsonField(payload->json, nodeName);
+            if(getUnparsedMember(payload, nodeName, true, &value))
+            {
+                haveUniqReference = (value != NULL);
+            }
+            else
+            {
+                value = json_incref(getEmbeddedJsonField(json, nodeName));
+                haveUniqReference = (value != NULL);
+            }
         }
+        json_decref(thawed);
         if(value == NULL)
         {
             REDFISH_DEBUG_ERR_PRINT("%s: Payload contains no element named %s\n", __func__, nodeName);
@@ -850,6 +1711,10 @@ bool getPayloadByNodeNameAsync(redfishPayload* payload, const char* nodeName, re
     }
     if(isOdataIdNode(value, &uri))
     {
+        if(haveUniqReference)
+        {
+            json_decref(value);
+        }
         ret = getUriFromServiceAsync(payload->service, uri, options, callback, context);
         free(uri);
         return ret;
@@ -865,7 +1730,7 @@ bool getPayloadByNodeNameAsync(redfishPayload* payload, const char* nodeName, re
         json_decref(value);
         value = odataId;
     }
-    retPayload = createRedfishPayload(value, payload->service);
+    retPayload = createChildPayload(value, payload);
     callback(true, 200, retPayload, context);
     return true;
 }
@@ -876,6 +1741,7 @@ bool getPayloadByIndexAsync(redfishPayload* payload, size_t index, redfishAsyncO
     char* uri;
     bool ret;
     redfishPayload* retPayload;
+    size_t node;
 
     if(!payload)
     {
@@ -889,13 +1755,27 @@ bool getPayloadByIndexAsync(redfishPayload* payload, size_t index, redfishAsyncO
         cleanupPayload(members);
         return ret;
     }
-    if(json_is_array(payload->json))
+    if(isFrozen(payload))
+    {
+        if(tapeGetByIndex(payload->tape, payload->tapeNode, index, NULL, &node) == false)
+        {
+            return false;
+        }
+        if(frozenNodeNeedsJson(payload, node) == false)
+        {
+            retPayload = createFrozenChildPayload(payload, node);
+            callback(true, 200, retPayload, context);
+            return true;
+        }
+        value = tapeToJson(payload->tape, node);
+    }
+    else if(json_is_array(getPayloadJson(payload)))
     {
-        value = json_array_get(payload->json, index);
+        value = json_incref(json_array_get(getPayloadJson(payload), index));
     }
-    else if(json_is_object(payload->json))
+    else if(json_is_object(getPayloadJson(payload)))
     {
-        value = json_object_get_by_index(payload->json, index);
+        value = json_incref(getObjectMemberByIndex(payload, index));
     }
 
     if(value == NULL)
@@ -904,12 +1784,12 @@ bool getPayloadByIndexAsync(redfishPayload* payload, size_t index, redfishAsyncO
     }
     if(isOdataIdNode(value, &uri))
     {
+        json_decref(value);
         ret = getUriFromServiceAsync(payload->service, uri, options, callback, context);
         free(uri);
         return ret;
     }
-    json_incref(value);
-    retPayload = createRedfishPayload(value, payload->service);
+    retPayload = createChildPayload(value, payload);
     callback(true, 200, retPayload, context);
     return true;
 }
@@ -921,10 +1801,16 @@ typedef struct
     redfishAsyncCallback callback;
     /** The original context for the original callback **/
     void* originalContext;
-    /** The current redpath for this call **/
+    /** The plan being followed, a reference is held until the traversal is done **/
+    redPathPlan* plan;
+    /** The current redpath node for this call **/
     redPathNode* redpath;
     /** The options passed to the original call **/
     redfishAsyncOptions* options;
+    /** The URI of the resource this step was taken from if the service remembers steps, NULL otherwise **/
+    char* fromUri;
+    /** options without the query options, used for every step but the last **/
+    redfishAsyncOptions hopOptions;
 } redpathAsyncContext;
 
 void gotNextRedPath(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
@@ -934,37 +1820,39 @@ void gotNextRedPath(bool success, unsigned short httpCode, redfishPayload* paylo
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
 
+    if(myContext->fromUri)
+    {
+        if(success && httpCode < 300 && payload)
+        {
+            pathMemoRemember(payload->service, myContext->fromUri, myContext->redpath, payload);
+        }
+        free(myContext->fromUri);
+    }
     if(success == false || httpCode >= 400 || myContext->redpath->next == NULL)
     {
         myContext->callback(success, httpCode, payload, myContext->originalContext);
-        cleanupRedPath(myContext->redpath);
+        redpathPlanDecRef(myContext->plan);
         free(context);
         return;
     }
-    ret = getPayloadForPathAsync(payload, myContext->redpath->next, myContext->options, myContext->callback, myContext->originalContext);
+    ret = getPayloadForPlanAsync(payload, myContext->plan, myContext->redpath->next, myContext->options, myContext->callback, myContext->originalContext);
     cleanupPayload(payload);
     if(ret == false)
     {
         myContext->callback(ret, 0xFFFF, NULL, myContext->originalContext);
-        cleanupRedPath(myContext->redpath);
-    }
-    else
-    {
-        //Free just this redpath node...
-        myContext->redpath->next = NULL;
-        cleanupRedPath(myContext->redpath);
     }
+    redpathPlanDecRef(myContext->plan);
     free(context);
 }
 
-bool getPayloadForPathAsync(redfishPayload* payload, redPathNode* redpath, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+bool getPayloadForPlanAsync(redfishPayload* payload, redPathPlan* plan, redPathNode* redpath, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
 {
     redpathAsyncContext* myContext;
     bool ret;
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. payload = %p, redpath = %p\n", __func__, payload, redpath);
 
-    if(!payload || !redpath)
+    if(!payload || !plan || !redpath)
     {
         return false;
     }
@@ -977,54 +1865,484 @@ bool getPayloadForPathAsync(redfishPayload* payload, redPathNode* redpath, redfi
     }
     myContext->callback = callback;
     myContext->originalContext = context;
+    myContext->plan = redpathPlanIncRef(plan);
     myContext->redpath = redpath;
     myContext->options = options;
-
-    if(redpath->nodeName)
-    {
-        ret = getPayloadByNodeNameAsync(payload, redpath->nodeName, options, gotNextRedPath, myContext);
-    }
-    else if(redpath->isIndex)
+    myContext->fromUri = NULL;
+    if(pathMemoEnabled(payload->service) && pathMemoStep(redpath))
     {
-        ret = getPayloadByIndexAsync(payload, redpath->index, options, gotNextRedPath, myContext);
+        myContext->fromUri = getPayloadUri(payload);
     }
-    else
+
+    //The caller's query options are for the resource at the end of the path, not the ones on the way there
+    if(redpath->next)
     {
-        ret = getOpResultAsync(payload, redpath->propName, redpath->op, redpath->value, options, gotNextRedPath, myContext);
+        options = odataQueryStripOptions(&myContext->hopOptions, options);
     }
+    ret = getPayloadForNodeAsync(payload, redpath, options, gotNextRedPath, myContext);
     if(ret == false)
     {
+        redpathPlanDecRef(plan);
+        free(myContext->fromUri);
         free(myContext);
     }
     return ret;
 }
 
-bool getPayloadForPathStringAsync(redfishPayload* payload, const char* string, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+/** Internal structure used to apply the caller's query options to the result of a RedPath operation **/
+typedef struct
 {
-    redPathNode* redpath;
+    /** The original callback **/
+    redfishAsyncCallback callback;
+    /** The original context for the original callback **/
+    void* originalContext;
+    /** The caller's options, with the query options to apply **/
+    redfishAsyncOptions* options;
+    /** The caller's options without the query options, used to read what the operation is evaluated on **/
+    redfishAsyncOptions opOptions;
+} redpathQueryContext;
+
+bool getPayloadForNodeAsync(redfishPayload* payload, redPathNode* redpath, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    redpathQueryContext* myContext;
     bool ret;
 
-    if(!payload || !string)
+    if(redpath->nodeName)
     {
-        return false;
+        return getPayloadByNodeNameAsync(payload, redpath->nodeName, options, callback, context);
+    }
+    else if(redpath->isIndex)
+    {
+        return getPayloadByIndexAsync(payload, redpath->index, options, callback, context);
+    }
+    if(odataQueryRequested(options) == 0)
+    {
+        return getOpResultAsync(payload, redpath->propName, redpath->op, redpath->value, getOpIntValue(redpath), options, callback, context);
     }
-    redpath = parseRedPath(string);
-    if(!redpath)
+    //The members have to be read whole for the operation to see the property, the query options apply to the result
+    myContext = malloc(sizeof(redpathQueryContext));
+    if(myContext == NULL)
     {
         return false;
     }
-    ret = getPayloadForPathAsync(payload, redpath, options, callback, context);
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->options = options;
+    odataQueryStripOptions(&myContext->opOptions, options);
+    ret = getOpResultAsync(payload, redpath->propName, redpath->op, redpath->value, getOpIntValue(redpath), &myContext->opOptions, gotOpResultForQuery, myContext);
     if(ret == false)
     {
-        cleanupRedPath(redpath);
+        free(myContext);
     }
     return ret;
 }
 
-bool patchPayloadAsync(redfishPayload* target, redfishPayload* payload, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+static void gotOpResultForQuery(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
 {
-    char* uri;
-    bool ret;
+    redpathQueryContext* myContext = (redpathQueryContext*)context;
+
+    if(success && httpCode < 300 && payload)
+    {
+        odataQueryApplyLocally(payload, myContext->options, odataQueryRequested(myContext->options), httpCode, myContext->callback, myContext->originalContext);
+    }
+    else
+    {
+        myContext->callback(success, httpCode, payload, myContext->originalContext);
+    }
+    free(myContext);
+}
+
+bool getPayloadForPathAsync(redfishPayload* payload, redPathNode* redpath, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    redPathPlan* plan;
+    bool ret;
+
+    if(!payload || !redpath)
+    {
+        return false;
+    }
+    //The traversal owns the nodes from here on, unless it can't be started
+    plan = redpathPlanWrap(redpath);
+    if(plan == NULL)
+    {
+        return false;
+    }
+    ret = getPayloadForPlanAsync(payload, plan, redpath, options, callback, context);
+    if(ret == false)
+    {
+        redpathPlanUnwrap(plan);
+        return false;
+    }
+    redpathPlanDecRef(plan);
+    return true;
+}
+
+bool getPayloadForPathStringAsync(redfishPayload* payload, const char* string, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    redPathPlan* plan;
+    bool ret;
+
+    if(!payload || !string)
+    {
+        return false;
+    }
+    plan = redpathPlanGet(string);
+    if(!plan)
+    {
+        return false;
+    }
+    ret = getPayloadForPlanAsync(payload, plan, redpathPlanNodes(plan), options, callback, context);
+    redpathPlanDecRef(plan);
+    return ret;
+}
+
+/** A member that has arrived but has not been reported yet **/
+typedef struct
+{
+    /** Set once the member has arrived **/
+    bool arrived;
+    /** Whether the member was obtained **/
+    bool success;
+    /** The HTTP status for the member **/
+    unsigned short httpCode;
+    /** The member **/
+    redfishPayload* payload;
+} heldMember;
+
+/** Internal structure used for streaming the members of a collection **/
+typedef struct
+{
+    /** The callback for each member **/
+    redfishMemberCallback callback;
+    /** The original context for the callback **/
+    void* originalContext;
+    /** One of the REDFISH_MEMBER_ORDER_* values **/
+    int order;
+    /** Protects the state below, it is never held while the callback runs **/
+    mutex lock;
+    /** The number of members not yet reported **/
+    size_t left;
+    /** REDFISH_MEMBER_ORDER_COLLECTION only, the next member to report **/
+    size_t next;
+    /** The number of members in the collection **/
+    size_t count;
+    /** Set if any member could not be obtained **/
+    bool failed;
+    /** The members that arrived and have not been reported yet **/
+    heldMember* held;
+    /** REDFISH_MEMBER_ORDER_COMPLETION only, the index of each member in the order they arrived **/
+    size_t* ready;
+    /** REDFISH_MEMBER_ORDER_COMPLETION only, the number of entries in ready **/
+    size_t readyCount;
+    /** REDFISH_MEMBER_ORDER_COMPLETION only, the next entry in ready to report **/
+    size_t readyNext;
+    /** The Members array, held until every member has been requested **/
+    redfishPayload* members;
+    /** The options for each member request **/
+    redfishAsyncOptions* options;
+    /** The number of members requested so far **/
+    size_t started;
+    /** The number of member requests outstanding **/
+    size_t inFlight;
+    /** The most member requests to have outstanding at once **/
+    size_t window;
+    /** Set while a thread is starting member requests, that thread reports what arrived in the meantime **/
+    bool starting;
+    /** Set while a thread is calling the callback, so members are reported one at a time **/
+    bool reporting;
+    /** Set while the first report is queued to the async thread **/
+    bool reportQueued;
+} memberStreamContext;
+
+/** The context for obtaining a single member of a streamed collection **/
+typedef struct
+{
+    /** The overall context **/
+    memberStreamContext* parent;
+    /** The position of this member in the collection **/
+    size_t index;
+} memberStreamFetch;
+
+/*Called with the lock held, keeps a member until it can be reported*/
+static void memberStreamHold(memberStreamContext* myContext, bool success, unsigned short httpCode, redfishPayload* payload, size_t index)
+{
+    heldMember* held = &myContext->held[index];
+
+    if(success == false || httpCode >= 300 || payload == NULL)
+    {
+        myContext->failed = true;
+    }
+    held->arrived = true;
+    held->success = success;
+    held->httpCode = httpCode;
+    held->payload = payload;
+    if(myContext->order == REDFISH_MEMBER_ORDER_COMPLETION)
+    {
+        myContext->ready[myContext->readyCount++] = index;
+    }
+}
+
+/*Called with the lock held, takes the next member that can be reported*/
+static bool memberStreamNext(memberStreamContext* myContext, heldMember* member, size_t* index)
+{
+    if(myContext->order == REDFISH_MEMBER_ORDER_COMPLETION)
+    {
+        if(myContext->readyNext == myContext->readyCount)
+        {
+            return false;
+        }
+        *index = myContext->ready[myContext->readyNext++];
+    }
+    else
+    {
+        if(myContext->next >= myContext->count || myContext->held[myContext->next].arrived == false)
+        {
+            return false;
+        }
+        *index = myContext->next++;
+    }
+    *member = myContext->held[*index];
+    myContext->left--;
+    return true;
+}
+
+/*Called with the lock held, reports the members that can be reported with the lock released, then releases the lock and finishes the stream once every member is reported*/
+static void memberStreamReport(memberStreamContext* myContext)
+{
+    heldMember member;
+    size_t index;
+    bool done;
+
+    if(myContext->reporting)
+    {
+        //The thread already reporting picks up anything that arrived
+        mutex_unlock(&myContext->lock);
+        return;
+    }
+    myContext->reporting = true;
+    while(memberStreamNext(myContext, &member, &index))
+    {
+        mutex_unlock(&myContext->lock);
+        myContext->callback(member.success, member.httpCode, member.payload, index, myContext->originalContext);
+        mutex_lock(&myContext->lock);
+    }
+    myContext->reporting = false;
+    done = (myContext->left == 0 && myContext->starting == false && myContext->reportQueued == false);
+    mutex_unlock(&myContext->lock);
+    if(done == false)
+    {
+        return;
+    }
+    myContext->callback(!myContext->failed, 200, NULL, REDFISH_MEMBERS_END, myContext->originalContext);
+    cleanupPayload(myContext->members);
+    mutex_destroy(&myContext->lock);
+    free(myContext->held);
+    free(myContext->ready);
+    free(myContext);
+}
+
+/*Runs on the async thread, so nothing is reported from inside the call that started the stream*/
+static void memberStreamReportLater(void* context)
+{
+    memberStreamContext* myContext = (memberStreamContext*)context;
+
+    mutex_lock(&myContext->lock);
+    myContext->reportQueued = false;
+    memberStreamReport(myContext);
+}
+
+/*Called with the lock held and starting set, starts member requests until the window is full and clears starting*/
+static void memberStreamStart(memberStreamContext* myContext)
+{
+    memberStreamFetch* fetch;
+
+    while(myContext->inFlight < myContext->window && myContext->started < myContext->count)
+    {
+        fetch = (memberStreamFetch*)malloc(sizeof(memberStreamFetch));
+        if(fetch == NULL)
+        {
+            memberStreamHold(myContext, false, 0xFFFF, NULL, myContext->started++);
+            continue;
+        }
+        fetch->parent = myContext;
+        fetch->index = myContext->started++;
+        myContext->inFlight++;
+        mutex_unlock(&myContext->lock);
+        if(getPayloadByIndexAsync(myContext->members, fetch->index, myContext->options, gotStreamMemberAsync, fetch))
+        {
+            mutex_lock(&myContext->lock);
+            continue;
+        }
+        mutex_lock(&myContext->lock);
+        myContext->inFlight--;
+        memberStreamHold(myContext, false, 0xFFFF, NULL, fetch->index);
+        free(fetch);
+    }
+    myContext->starting = false;
+}
+
+static void gotStreamMemberAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    memberStreamFetch* fetch = (memberStreamFetch*)context;
+    memberStreamContext* myContext = fetch->parent;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    mutex_lock(&myContext->lock);
+    memberStreamHold(myContext, success, httpCode, payload, fetch->index);
+    myContext->inFlight--;
+    free(fetch);
+    if(myContext->starting)
+    {
+        //The thread already starting requests will fill the free slot and report this member
+        mutex_unlock(&myContext->lock);
+        return;
+    }
+    myContext->starting = true;
+    memberStreamStart(myContext);
+    memberStreamReport(myContext);
+}
+
+/*Takes ownership of elements, the Members of a collection or an array*/
+static bool streamElementsAsync(redfishPayload* elements, int order, redfishAsyncOptions* options, redfishMemberCallback callback, void* context)
+{
+    memberStreamContext* myContext;
+
+    myContext = (memberStreamContext*)calloc(1, sizeof(memberStreamContext));
+    if(myContext == NULL)
+    {
+        cleanupPayload(elements);
+        return false;
+    }
+    myContext->count = json_array_size(getPayloadJson(elements));
+    if(myContext->count)
+    {
+        myContext->held = (heldMember*)calloc(myContext->count, sizeof(heldMember));
+        if(order == REDFISH_MEMBER_ORDER_COMPLETION)
+        {
+            myContext->ready = (size_t*)calloc(myContext->count, sizeof(size_t));
+        }
+        if(myContext->held == NULL || (order == REDFISH_MEMBER_ORDER_COMPLETION && myContext->ready == NULL))
+        {
+            cleanupPayload(elements);
+            free(myContext->held);
+            free(myContext->ready);
+            free(myContext);
+            return false;
+        }
+    }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->order = order;
+    myContext->left = myContext->count;
+    myContext->members = elements;
+    myContext->options = options;
+    myContext->window = getMaxInFlight(options);
+    mutex_init(&myContext->lock);
+    mutex_lock(&myContext->lock);
+    myContext->starting = true;
+    memberStreamStart(myContext);
+    //Anything that arrived while starting, including the end of an empty collection, is reported from the async thread
+    myContext->reportQueued = true;
+    mutex_unlock(&myContext->lock);
+    if(elements == NULL || elements->service == NULL || queueAsyncWork(elements->service, memberStreamReportLater, myContext) == false)
+    {
+        memberStreamReportLater(myContext);
+    }
+    return true;
+}
+
+bool getCollectionMembersAsync(redfishPayload* collection, int order, redfishAsyncOptions* options, redfishMemberCallback callback, void* context)
+{
+    if(!collection || !callback || !isPayloadCollection(collection))
+    {
+        return false;
+    }
+    //Use the members actually present, Members@odata.count may include members that were not read
+    return streamElementsAsync(getPayloadByNodeName(collection, "Members"), order, options, callback, context);
+}
+
+/** Internal structure used by the sync API to wait for elements read in parallel **/
+typedef struct
+{
+    /** Protects done **/
+    mutex lock;
+    /** Signalled once every element has been read **/
+    condition finished;
+    /** Set once every element has been read **/
+    bool done;
+    /** The elements, NULL for any that could not be read **/
+    redfishPayload** payloads;
+} syncElementsContext;
+
+static void gotSyncElement(bool success, unsigned short httpCode, redfishPayload* payload, size_t index, void* context)
+{
+    syncElementsContext* myContext = (syncElementsContext*)context;
+
+    if(index == REDFISH_MEMBERS_END)
+    {
+        mutex_lock(&myContext->lock);
+        myContext->done = true;
+        cond_broadcast(&myContext->finished);
+        mutex_unlock(&myContext->lock);
+        return;
+    }
+    if(success == true && httpCode < 300)
+    {
+        myContext->payloads[index] = payload;
+    }
+    else
+    {
+        cleanupPayload(payload);
+    }
+}
+
+/*Returns NULL if the elements are inline or can't be read in parallel, the caller then reads them one at a time*/
+static redfishPayload** getElementsInParallel(redfishPayload* elements, size_t count)
+{
+    syncElementsContext myContext;
+    char* uri;
+
+    if(count < 2 || elements == NULL || elements->service == NULL || isOnAsyncThread(elements->service))
+    {
+        return NULL;
+    }
+    if(isOdataIdNode(json_array_get(getPayloadJson(elements), 0), &uri) == false)
+    {
+        return NULL;
+    }
+    free(uri);
+    myContext.payloads = (redfishPayload**)calloc(count, sizeof(redfishPayload*));
+    if(myContext.payloads == NULL)
+    {
+        return NULL;
+    }
+    myContext.done = false;
+    mutex_init(&myContext.lock);
+    cond_init(&myContext.finished);
+    if(streamElementsAsync(copyRedfishPayload(elements), REDFISH_MEMBER_ORDER_COMPLETION, NULL, gotSyncElement, &myContext) == false)
+    {
+        free(myContext.payloads);
+        myContext.payloads = NULL;
+    }
+    else
+    {
+        mutex_lock(&myContext.lock);
+        while(myContext.done == false)
+        {
+            cond_wait(&myContext.finished, &myContext.lock);
+        }
+        mutex_unlock(&myContext.lock);
+    }
+    cond_destroy(&myContext.finished);
+    mutex_destroy(&myContext.lock);
+    return myContext.payloads;
+}
+
+bool patchPayloadAsync(redfishPayload* target, redfishPayload* payload, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    char* uri;
+    bool ret;
     redfishService* service;
 
     if(!target || !payload)
@@ -1122,11 +2440,11 @@ static bool stringCompareOpResult(const char* str1, const char* str2, RedPathOp
     return intCompareOpResult(tmp, 0, op);
 }
 
-static bool getSimpleOpResult(json_t* json, const char* propName, RedPathOp op, const char* value)
+static bool getSimpleOpResult(json_t* json, const char* propName, RedPathOp op, const char* value, long long intValue)
 {
     json_t* stringProp = json;
     const char* propStr;
-    long long intVal, intPropVal;
+    long long intPropVal;
     bool ret;
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. json = %p, propName = %s, op = %u, value = %s\n", __func__, json, propName, op, value);
@@ -1167,8 +2485,7 @@ static bool getSimpleOpResult(json_t* json, const char* propName, RedPathOp op,
             break;
         case JSON_INTEGER:
             intPropVal = json_integer_value(json);
-            intVal = strtoll(value, NULL, 0);
-            ret = intCompareOpResult(intPropVal, intVal, op);
+            ret = intCompareOpResult(intPropVal, intValue, op);
             break;
         case JSON_NULL:
             ret = stringCompareOpResult(value, "null", op);
@@ -1181,18 +2498,28 @@ static bool getSimpleOpResult(json_t* json, const char* propName, RedPathOp op,
     return ret;
 }
 
-static redfishPayload* getOpResult(redfishPayload* payload, const char* propName, RedPathOp op, const char* value)
+/*The operation's value as an integer, parsed once per step rather than once per member compared*/
+static long long getOpIntValue(redPathNode* redpath)
+{
+    if(redpath->value == NULL)
+    {
+        return 0;
+    }
+    return strtoll(redpath->value, NULL, 0);
+}
+
+static redfishPayload* getOpResult(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue)
 {
     bool ret = false;
     redfishPayload* prop;
 
     if(isPayloadCollection(payload))
     {
-        return collectionEvalOp(payload, propName, op, value);
+        return collectionEvalOp(payload, propName, op, value, intValue);
     }
     if(isPayloadArray(payload))
     {
-        return arrayEvalOp(payload, propName, op, value);
+        return arrayEvalOp(payload, propName, op, value, intValue);
     }
 
     prop = getPayloadByNodeName(payload, propName);
@@ -1200,7 +2527,7 @@ static redfishPayload* getOpResult(redfishPayload* payload, const char* propName
     {
         return NULL;
     }
-    ret = getSimpleOpResult(prop->json, propName, op, value);
+    ret = getSimpleOpResult(getPayloadJson(prop), propName, op, value, intValue);
     cleanupPayload(prop);
     if(ret)
     {
@@ -1221,6 +2548,8 @@ typedef struct
     void* originalContext;
     /** The options passed to the original call **/
     redfishAsyncOptions* options;
+    /** options without the query options, to read a collection with the $filter or $expand made for the operation **/
+    redfishAsyncOptions queryOptions;
     /** The payload the operation was called on **/
     redfishPayload* payload;
     /** The property name to retrieve **/
@@ -1229,6 +2558,8 @@ typedef struct
     RedPathOp op;
     /** The value for the operation **/
     char* value;
+    /** The value for the operation parsed as an integer **/
+    long long intValue;
     /** The number of operations to perform (i.e. a collection or array has to perform the operation on each element) **/
     size_t count;
     /** The number of operations left **/
@@ -1237,6 +2568,24 @@ typedef struct
     size_t validCount;
     /** A set of payloads for the collection **/
     redfishPayload** payloads;
+    /** The collection members or array the operation reads, held until every element has been requested **/
+    redfishPayload* source;
+    /** The index in source of the first element to read **/
+    size_t first;
+    /** The number of elements requested so far **/
+    size_t next;
+    /** The number of element requests outstanding **/
+    size_t inFlight;
+    /** The most element requests to have outstanding at once **/
+    size_t window;
+    /** Set while a thread is starting element requests, that thread also finishes the operation **/
+    bool starting;
+    /** Set once any element request has been started **/
+    bool anyWork;
+    /** REDFISH_ASYNC_FLAG_FIRST_MATCH only, set once a match has been reported **/
+    bool matched;
+    /** Elements can complete on the async thread while others are still being requested **/
+    mutex lock;
 } redpathAsyncOpContext;
 
 static void opGotPayloadByNodeNameAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
@@ -1253,7 +2602,7 @@ static void opGotPayloadByNodeNameAsync(bool success, unsigned short httpCode, r
         free(myContext);
         return;
     }
-    ret = getSimpleOpResult(payload->json, myContext->propName, myContext->op, myContext->value);
+    ret = getSimpleOpResult(getPayloadJson(payload), myContext->propName, myContext->op, myContext->value, myContext->intValue);
     cleanupPayload(payload);
     if(ret)
     {
@@ -1269,7 +2618,7 @@ static void opGotPayloadByNodeNameAsync(bool success, unsigned short httpCode, r
     free(myContext);
 }
 
-static bool getOpResultAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+static bool getOpResultAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
 {
     bool ret;
     redpathAsyncOpContext* myContext;
@@ -1278,11 +2627,11 @@ static bool getOpResultAsync(redfishPayload* payload, const char* propName, RedP
 
     if(isPayloadCollection(payload))
     {
-        return collectionEvalOpAsync(payload, propName, op, value, options, callback, context);
+        return collectionEvalOpAsync(payload, propName, op, value, intValue, options, callback, context);
     }
     if(isPayloadArray(payload))
     {
-        return arrayEvalOpAsync(payload, propName, op, value, options, callback, context);
+        return arrayEvalOpAsync(payload, propName, op, value, intValue, options, callback, context);
     }
     if(op == REDPATH_OP_ANY || op == REDPATH_OP_LAST)
     {
@@ -1301,6 +2650,7 @@ static bool getOpResultAsync(redfishPayload* payload, const char* propName, RedP
     myContext->propName = safeStrdup(propName);
     myContext->op = op;
     myContext->value = safeStrdup(value);
+    myContext->intValue = intValue;
     ret = getPayloadByNodeNameAsync(payload, propName, options, opGotPayloadByNodeNameAsync, myContext);
     if(ret == false)
     {
@@ -1309,33 +2659,57 @@ static bool getOpResultAsync(redfishPayload* payload, const char* propName, RedP
     return ret;
 }
 
-static redfishPayload* collectionEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value)
+static redfishPayload* collectionEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue)
 {
     redfishPayload* ret;
     redfishPayload* tmp;
     redfishPayload* members;
+    redfishPayload* queried = NULL;
     redfishPayload** valid;
+    redfishPayload** fetched;
+    json_t* json;
+    char* queryUri;
     size_t validMax;
     size_t validCount = 0;
     size_t i;
 
+    queryUri = getCollectionQueryUri(payload, propName, op, value);
+    if(queryUri)
+    {
+        //Let the service filter and/or inline the members instead of reading each one
+        json = getUriFromService(payload->service, queryUri);
+        free(queryUri);
+        if(json)
+        {
+            queried = createRedfishPayload(json, payload->service);
+            if(queried && isPayloadCollection(queried))
+            {
+                payload = queried;
+            }
+        }
+    }
+
     validMax = getCollectionSize(payload);
     if(validMax == 0)
     {
+        cleanupPayload(queried);
         return NULL;
     }
 
     valid = (redfishPayload**)calloc(validMax, sizeof(redfishPayload*));
     if(valid == NULL)
     {
+        cleanupPayload(queried);
         return NULL;
     }
     /*Technically getPayloadByIndex would do this, but this optimizes things*/
     members = getPayloadByNodeName(payload, "Members");
+    //Members that are only links are read together through the async engine rather than one GET at a time
+    fetched = getElementsInParallel(members, validMax);
     for(i = 0; i < validMax; i++)
     {
-        tmp = getPayloadByIndex(members, i);
-        valid[validCount] = getOpResult(tmp, propName, op, value);
+        tmp = fetched ? fetched[i] : getPayloadByIndex(members, i);
+        valid[validCount] = getOpResult(tmp, propName, op, value, intValue);
         if(valid[validCount] != NULL)
         {
             validCount++;
@@ -1346,23 +2720,34 @@ static redfishPayload* collectionEvalOp(redfishPayload* payload, const char* pro
         }
     }
     cleanupPayload(members);
+    free(fetched);
     if(validCount == 0)
     {
         free(valid);
+        cleanupPayload(queried);
         return NULL;
     }
     if(validCount == 1)
     {
         ret = valid[0];
-        free(valid);
-        return ret;
     }
     else
     {
         ret = createCollection(payload->service, validCount, valid);
-        free(valid);
-        return ret;
     }
+    free(valid);
+    cleanupPayload(queried);
+    return ret;
+}
+
+static void freeByIndexTransaction(redpathAsyncOpContext* myContext)
+{
+    cleanupPayload(myContext->source);
+    mutex_destroy(&myContext->lock);
+    free(myContext->propName);
+    free(myContext->value);
+    free(myContext->payloads);
+    free(myContext);
 }
 
 static void opFinishByIndexTransaction(redpathAsyncOpContext* myContext)
@@ -1373,6 +2758,12 @@ static void opFinishByIndexTransaction(redpathAsyncOpContext* myContext)
     {
         return;
     }
+    if(myContext->matched)
+    {
+        //The callback already has its result
+        freeByIndexTransaction(myContext);
+        return;
+    }
 
     if(myContext->validCount == 0)
     {
@@ -1388,74 +2779,301 @@ static void opFinishByIndexTransaction(redpathAsyncOpContext* myContext)
     }
 
     myContext->callback(true, 200, returnValue, myContext->originalContext);
-    free(myContext->propName);
-    free(myContext->value);
-    free(myContext->payloads);
-    free(myContext);
+    freeByIndexTransaction(myContext);
 }
 
-static void opGotResultAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+static redpathAsyncOpContext* newByIndexTransaction(redfishPayload* source, size_t first, size_t count, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
 {
-    redpathAsyncOpContext* myContext = (redpathAsyncOpContext*)context;
-
-    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+    redpathAsyncOpContext* myContext;
 
-    if(success == true && httpCode < 300 && payload != NULL)
-    {
-        myContext->payloads[myContext->validCount++] = payload;
-    }
-    else if(payload)
+    myContext = (redpathAsyncOpContext*)calloc(1, sizeof(redpathAsyncOpContext));
+    if(myContext == NULL)
     {
-        cleanupPayload(payload);
+        return NULL;
     }
-
-    myContext->left--;
-    if(myContext->left == 0)
+    myContext->payloads = (redfishPayload**)calloc(count, sizeof(redfishPayload*));
+    if(myContext->payloads == NULL)
     {
-        opFinishByIndexTransaction(myContext);
+        free(myContext);
+        return NULL;
     }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->options = options;
+    myContext->propName = safeStrdup(propName);
+    myContext->op = op;
+    myContext->value = safeStrdup(value);
+    myContext->intValue = intValue;
+    myContext->count = count;
+    myContext->left = count;
+    myContext->source = source;
+    myContext->first = first;
+    myContext->window = getMaxInFlight(options);
+    mutex_init(&myContext->lock);
+    return myContext;
 }
 
-static void opGotPayloadByIndexAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+/*Called with the lock held and starting set, returns with the lock released. Returns true if the operation is ready to finish*/
+static bool startByIndexRequests(redpathAsyncOpContext* myContext)
 {
-    redpathAsyncOpContext* myContext = (redpathAsyncOpContext*)context;
+    size_t index;
     bool ret;
 
-    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
-
-    if(success == true && httpCode < 300 && payload != NULL)
+    while(myContext->inFlight < myContext->window && myContext->next < myContext->count)
     {
-        ret = getOpResultAsync(payload, myContext->propName, myContext->op, myContext->value, myContext->options, opGotResultAsync, myContext);
-        if(ret == true)
+        index = myContext->first + myContext->next;
+        myContext->next++;
+        myContext->inFlight++;
+        mutex_unlock(&myContext->lock);
+        ret = getPayloadByIndexAsync(myContext->source, index, myContext->options, opGotPayloadByIndexAsync, myContext);
+        mutex_lock(&myContext->lock);
+        if(ret == false)
         {
-            return;
+            myContext->inFlight--;
+            myContext->left--;
+        }
+        else
+        {
+            myContext->anyWork = true;
         }
     }
-    myContext->left--;
-    if(myContext->left == 0)
+    myContext->starting = false;
+    ret = (myContext->left == 0);
+    mutex_unlock(&myContext->lock);
+    return ret;
+}
+
+static bool startByIndexTransaction(redpathAsyncOpContext* myContext)
+{
+    mutex_lock(&myContext->lock);
+    myContext->starting = true;
+    if(startByIndexRequests(myContext) == false)
+    {
+        return true;
+    }
+    if(myContext->anyWork == false)
+    {
+        freeByIndexTransaction(myContext);
+        return false;
+    }
+    opFinishByIndexTransaction(myContext);
+    return true;
+}
+
+static void opElementDone(redpathAsyncOpContext* myContext, redfishPayload* valid)
+{
+    redfishAsyncCallback callback = myContext->callback;
+    void* originalContext = myContext->originalContext;
+    redfishPayload* match = NULL;
+    bool finish = false;
+
+    mutex_lock(&myContext->lock);
+    if(valid && myContext->matched)
+    {
+        //Arrived after the first match was reported
+        cleanupPayload(valid);
+    }
+    else if(valid && myContext->options && (myContext->options->flags & REDFISH_ASYNC_FLAG_FIRST_MATCH) &&
+            myContext->op != REDPATH_OP_ANY && myContext->op != REDPATH_OP_LAST)
+    {
+        //Report this match now, don't request any more elements and ignore those still outstanding
+        match = valid;
+        myContext->matched = true;
+        myContext->left -= myContext->count - myContext->next;
+        myContext->next = myContext->count;
+    }
+    else if(valid)
+    {
+        myContext->payloads[myContext->validCount++] = valid;
+    }
+    myContext->inFlight--;
+    myContext->left--;
+    if(myContext->starting)
+    {
+        //The thread already starting requests will fill the free slot and finish the operation
+        mutex_unlock(&myContext->lock);
+    }
+    else
+    {
+        myContext->starting = true;
+        finish = startByIndexRequests(myContext);
+    }
+    if(match)
+    {
+        callback(true, 200, match, originalContext);
+    }
+    if(finish)
     {
         opFinishByIndexTransaction(myContext);
     }
+}
+
+static void opGotResultAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    redpathAsyncOpContext* myContext = (redpathAsyncOpContext*)context;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    if(success == true && httpCode < 300 && payload != NULL)
+    {
+        opElementDone(myContext, payload);
+        return;
+    }
     if(payload)
     {
         cleanupPayload(payload);
     }
+    opElementDone(myContext, NULL);
 }
 
-static bool collectionEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+static void opGotPayloadByIndexAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
 {
-    size_t max;
-    size_t i;
+    redpathAsyncOpContext* myContext = (redpathAsyncOpContext*)context;
+    bool ret;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    if(success == true && httpCode < 300 && payload != NULL)
+    {
+        ret = getOpResultAsync(payload, myContext->propName, myContext->op, myContext->value, myContext->intValue, myContext->options, opGotResultAsync, myContext);
+        if(ret == true)
+        {
+            return;
+        }
+    }
+    if(payload)
+    {
+        cleanupPayload(payload);
+    }
+    opElementDone(myContext, NULL);
+}
+
+static void opGotQueriedCollectionAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    redpathAsyncOpContext* myContext = (redpathAsyncOpContext*)context;
+    redfishPayload* collection = myContext->payload;
     bool ret;
-    bool anyWork = false;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    if(success == true && httpCode < 300 && payload != NULL && isPayloadCollection(payload))
+    {
+        collection = payload;
+    }
+    else
+    {
+        REDFISH_DEBUG_WARNING_PRINT("%s: Unable to query collection, reading the members individually\n", __func__);
+    }
+    if(collection == payload && getCollectionSize(payload) == 0 && myContext->op != REDPATH_OP_ANY)
+    {
+        //The service filtered out every member, that is no match rather than an error
+        myContext->callback(true, 200, NULL, myContext->originalContext);
+    }
+    else
+    {
+        ret = collectionMembersEvalOpAsync(collection, myContext->propName, myContext->op, myContext->value, myContext->intValue, myContext->options, myContext->callback, myContext->originalContext);
+        if(ret == false)
+        {
+            myContext->callback(false, 0xFFFF, NULL, myContext->originalContext);
+        }
+    }
+    cleanupPayload(payload);
+    cleanupPayload(myContext->payload);
+    free(myContext->propName);
+    free(myContext->value);
+    free(myContext);
+}
+
+static bool collectionEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    redpathAsyncOpContext* myContext;
+    char* queryUri;
+    bool ret;
+
+    queryUri = getCollectionQueryUri(payload, propName, op, value);
+    if(queryUri == NULL)
+    {
+        return collectionMembersEvalOpAsync(payload, propName, op, value, intValue, options, callback, context);
+    }
+    myContext = malloc(sizeof(redpathAsyncOpContext));
+    if(myContext == NULL)
+    {
+        free(queryUri);
+        return collectionMembersEvalOpAsync(payload, propName, op, value, intValue, options, callback, context);
+    }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->options = options;
+    //Keep the original collection to fall back to, the caller frees the original once this returns
+    myContext->payload = copyRedfishPayload(payload);
+    myContext->propName = safeStrdup(propName);
+    myContext->op = op;
+    myContext->value = safeStrdup(value);
+    myContext->intValue = intValue;
+    //The URI already has its own query, the caller's would be added to it
+    ret = getUriFromServiceAsync(payload->service, queryUri, odataQueryStripOptions(&myContext->queryOptions, options), opGotQueriedCollectionAsync, myContext);
+    free(queryUri);
+    if(ret == false)
+    {
+        cleanupPayload(myContext->payload);
+        free(myContext->propName);
+        free(myContext->value);
+        free(myContext);
+        return collectionMembersEvalOpAsync(payload, propName, op, value, intValue, options, callback, context);
+    }
+    return true;
+}
+
+static char* getCollectionQueryUri(redfishPayload* payload, const char* propName, RedPathOp op, const char* value)
+{
+    json_t* first;
+    char* uri;
+    char* filter = NULL;
+    char* ret;
+    unsigned int features;
+
+    //Only worth it when every member would otherwise be fetched
+    if(op == REDPATH_OP_LAST || payload->service == NULL)
+    {
+        return NULL;
+    }
+    features = payload->service->protocolFeatures;
+    if(!(features & (SERVICE_FEATURE_EXPAND|SERVICE_FEATURE_FILTER)))
+    {
+        return NULL;
+    }
+    first = json_array_get(json_object_get(getPayloadJson(payload), "Members"), 0);
+    if(isOdataIdNode(first, &uri) == false)
+    {
+        //Empty, or the members are already inline
+        return NULL;
+    }
+    free(uri);
+    uri = getPayloadUri(payload);
+    if(uri == NULL)
+    {
+        return NULL;
+    }
+    if(features & SERVICE_FEATURE_FILTER)
+    {
+        //The members that come back are still checked here, so the filter only has to match a superset
+        filter = odataFilterFromRedPath(propName, op, value);
+    }
+    ret = odataCollectionUri(uri, features, filter);
+    free(filter);
+    free(uri);
+    return ret;
+}
+
+static bool collectionMembersEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    size_t max;
     redpathAsyncOpContext* myContext;
     redfishPayload* members;
     redfishPayload* tmp;
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. payload = %p, propName = %s, value = %s, context = %p\n", __func__, payload, propName, value, context);
 
-    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. payload = %p, propName = %s, value = %s, context = %p\n", __func__, payload, propName, value, context);
-
     max = getCollectionSize(payload);
     if(max == 0)
     {
@@ -1469,81 +3087,35 @@ static bool collectionEvalOpAsync(redfishPayload* payload, const char* propName,
         return false;
     }
 
-    myContext = malloc(sizeof(redpathAsyncOpContext));
-    if(myContext == NULL)
-    {
-        return false;
-    }
     /*Technically getPayloadByIndex would do this, but this optimizes things*/
     members = getPayloadByNodeName(payload, "Members");
     if(op == REDPATH_OP_LAST)
     {
-        myContext->callback = callback;
-        myContext->originalContext = context;
-        myContext->options = options;
-        myContext->propName = safeStrdup(propName);
-        myContext->op = op;
-        myContext->value = safeStrdup(value);
-        myContext->count = 1;
-        myContext->left = 1;
-        myContext->validCount = 0;
-        myContext->payloads = calloc(sizeof(redfishPayload*), 1);
-        ret = getPayloadByIndexAsync(members, max-1, options, opGotPayloadByIndexAsync, myContext);
-        if(ret == false)
-        {
-            myContext->left--;
-        }
-        else
-        {
-            anyWork = true;
-        }
+        myContext = newByIndexTransaction(members, max-1, 1, propName, op, value, intValue, options, callback, context);
     }
     else
     {
-        myContext->callback = callback;
-        myContext->originalContext = context;
-        myContext->options = options;
-        myContext->propName = safeStrdup(propName);
-        myContext->op = op;
-        myContext->value = safeStrdup(value);
-        myContext->count = max;
-        myContext->left = max;
-        myContext->validCount = 0;
-        myContext->payloads = calloc(sizeof(redfishPayload*), max);
-        for(i = 0; i < max; i++)
-        {
-            ret = getPayloadByIndexAsync(members, i, options, opGotPayloadByIndexAsync, myContext);
-            if(ret == false)
-            {
-                myContext->left--;
-            }
-            else
-            {
-                anyWork = true;
-            }
-        }
+        myContext = newByIndexTransaction(members, 0, max, propName, op, value, intValue, options, callback, context);
     }
-    cleanupPayload(members);
-    if(anyWork == false)
+    if(myContext == NULL)
     {
-        free(myContext->propName);
-        free(myContext->value);
-        free(myContext->payloads);
-        free(myContext);
+        cleanupPayload(members);
+        return false;
     }
-    return anyWork;
+    return startByIndexTransaction(myContext);
 }
 
-static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value)
+static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue)
 {
     redfishPayload* ret;
     redfishPayload* tmp;
     redfishPayload** valid;
+    redfishPayload** fetched;
     size_t validMax;
     size_t validCount = 0;
     size_t i;
 
-    validMax = json_array_size(payload->json);
+    validMax = getArraySize(payload);
     if(validMax == 0)
     {
         return NULL;
@@ -1554,10 +3126,11 @@ static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName
     {
         return NULL;
     }
+    fetched = getElementsInParallel(payload, validMax);
     for(i = 0; i < validMax; i++)
     {
-        tmp = getPayloadByIndex(payload, i);
-        valid[validCount] = getOpResult(tmp, propName, op, value);
+        tmp = fetched ? fetched[i] : getPayloadByIndex(payload, i);
+        valid[validCount] = getOpResult(tmp, propName, op, value, intValue);
         if(valid[validCount] != NULL)
         {
             validCount++;
@@ -1567,6 +3140,7 @@ static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName
             cleanupPayload(tmp);
         }
     }
+    free(fetched);
     if(validCount == 0)
     {
         free(valid);
@@ -1586,18 +3160,15 @@ static redfishPayload* arrayEvalOp(redfishPayload* payload, const char* propName
     }
 }
 
-static bool arrayEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+static bool arrayEvalOpAsync(redfishPayload* payload, const char* propName, RedPathOp op, const char* value, long long intValue, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
 {
     size_t max;
-    size_t i;
-    bool ret;
-    bool anyWork = false;
     redpathAsyncOpContext* myContext;
     redfishPayload* tmp;
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. payload = %p, propName = %s, value = %s, context = %p\n", __func__, payload, propName, value, context);
 
-    max = json_array_size(payload->json);
+    max = getArraySize(payload);
     if(max == 0)
     {
         if(op == REDPATH_OP_ANY)
@@ -1610,41 +3181,28 @@ static bool arrayEvalOpAsync(redfishPayload* payload, const char* propName, RedP
         return false;
     }
 
-    myContext = malloc(sizeof(redpathAsyncOpContext));
-    if(myContext == NULL)
+    //The caller frees the array once this returns, but later elements are requested after that
+    tmp = copyRedfishPayload(payload);
+    if(tmp == NULL)
     {
         return false;
     }
-    myContext->callback = callback;
-    myContext->originalContext = context;
-    myContext->options = options;
-    myContext->propName = safeStrdup(propName);
-    myContext->op = op;
-    myContext->value = safeStrdup(value);
-    myContext->count = max;
-    myContext->left = max;
-    myContext->validCount = 0;
-    myContext->payloads = calloc(sizeof(redfishPayload*), max);
-    for(i = 0; i < max; i++)
+    myContext = newByIndexTransaction(tmp, 0, max, propName, op, value, intValue, options, callback, context);
+    if(myContext == NULL)
     {
-        ret = getPayloadByIndexAsync(payload, i, options, opGotPayloadByIndexAsync, myContext);
-        if(ret == false)
-        {
-            myContext->left--;
-        }
-        else
-        {
-            anyWork = true;
-        }
+        cleanupPayload(tmp);
+        return false;
     }
-    if(anyWork == false)
+    return startByIndexTransaction(myContext);
+}
+
+static size_t getMaxInFlight(redfishAsyncOptions* options)
+{
+    if(options == NULL || options->maxInFlight == 0)
     {
-        free(myContext->propName);
-        free(myContext->value);
-        free(myContext->payloads);
-        free(myContext);
+        return REDFISH_DEFAULT_MAX_IN_FLIGHT;
     }
-    return anyWork;
+    return options->maxInFlight;
 }
 
 static redfishPayload* createCollection(redfishService* service, size_t count, redfishPayload** payloads)
@@ -1653,6 +3211,7 @@ static redfishPayload* createCollection(redfishService* service, size_t count, r
     json_t* collectionJson = json_object();
     json_t* jcount = json_integer((json_int_t)count);
     json_t* members = json_array();
+    payloadArena* arena = NULL;
     size_t i;
 
     if(!collectionJson)
@@ -1668,13 +3227,40 @@ static redfishPayload* createCollection(redfishService* service, size_t count, r
     json_decref(jcount);
     for(i = 0; i < count; i++)
     {
-        json_array_append(members, payloads[i]->json);
+        if(payloads[i]->arena == NULL)
+        {
+            json_array_append(members, getPayloadJson(payloads[i]));
+        }
+        else
+        {
+            //The member json lives in the member's arena, so the collection needs to keep that arena alive
+            if(arena == NULL)
+            {
+                arena = arenaCreate();
+            }
+            if(arena != NULL && arenaAdopt(arena, payloads[i]->arena))
+            {
+                json_array_append(members, getPayloadJson(payloads[i]));
+            }
+            else
+            {
+                json_array_append_new(members, json_deep_copy(getPayloadJson(payloads[i])));
+            }
+        }
         cleanupPayload(payloads[i]);
     }
     json_object_set(collectionJson, "Members", members);
     json_decref(members);
 
     ret = createRedfishPayload(collectionJson, service);
+    if(ret)
+    {
+        ret->arena = arena;
+    }
+    else
+    {
+        arenaDecRef(arena);
+    }
     return ret;
 }
 
@@ -1720,4 +3306,465 @@ static bool isOdataIdNode(json_t* json, char** uriPtr)
     *uriPtr = safeStrdup(uri);
     return true;
 }
+static bool isUnparsedJson(redfishPayload* payload)
+{
+    return (payload != NULL && loadPointer((void**)&(payload->json)) == NULL && payload->contentType == PAYLOAD_CONTENT_JSON && payload->content != NULL);
+}
+
+/**
+ * Obtain a member of a payload that has not been parsed yet by parsing just that member's text.
+ * Returns false if the payload has already been parsed or the raw text can't be scanned, in which case the caller should use getPayloadJson().
+ * Otherwise value is set to a new reference to the member or NULL if there is no such member.
+ */
+static bool getUnparsedMember(redfishPayload* payload, const char* name, bool isPath, json_t** value)
+{
+    jsonScanResult res;
+    jsonSpan span;
+    json_error_t err;
+
+    if(!isUnparsedJson(payload))
+    {
+        return false;
+    }
+    if(isPath)
+    {
+        res = jsonScanObjectPath(payload->content, payload->contentLength, name, &span);
+    }
+    else
+    {
+        res = jsonScanObjectMember(payload->content, payload->contentLength, name, strlen(name), &span);
+    }
+    switch(res)
+    {
+        case JSONSCAN_NOT_FOUND:
+            *value = NULL;
+            return true;
+        case JSONSCAN_FOUND:
+            *value = json_loadb(span.start, span.length, JSON_DECODE_ANY, &err);
+            if(*value == NULL)
+            {
+                REDFISH_DEBUG_WARNING_PRINT("%s: Unable to parse member %s, falling back to full parse. %s\n", __func__, name, err.text);
+                return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+static redfishPayload* createChildPayload(json_t* value, redfishPayload* parent)
+{
+    redfishPayload* ret = createRedfishPayload(value, parent->service);
+    if(ret)
+    {
+        //The value may point into the parent's arena or into a tree the parent shares with a copy
+        ret->arena = arenaIncRef(parent->arena);
+        if(parent->jsonShare)
+        {
+            ret->jsonShare = parent->jsonShare;
+#ifdef _MSC_VER
+#if _M_AMD64
+            InterlockedIncrement64(&(ret->jsonShare->refCount));
+#else
+            InterlockedIncrement(&(ret->jsonShare->refCount));
+#endif
+#else
+            __sync_fetch_and_add(&(ret->jsonShare->refCount), 1);
+#endif
+        }
+    }
+    return ret;
+}
+static bool isFrozen(redfishPayload* payload)
+{
+    return (payload != NULL && loadPointer((void**)&(payload->json)) == NULL && payload->tape != NULL);
+}
+
+/**
+ * Find a member of a frozen payload, following a dotted path if isPath is set.
+ * Returns true and sets node if the member exists.
+ */
+static bool getFrozenMember(redfishPayload* payload, const char* name, bool isPath, size_t* node)
+{
+    const char* end;
+
+    *node = payload->tapeNode;
+    if(isPath == false || strchr(name, '.') == NULL)
+    {
+        return tapeObjectGet(payload->tape, *node, name, strlen(name), node);
+    }
+    while(*name)
+    {
+        end = strchr(name, '.');
+        if(end == NULL)
+        {
+            end = name + strlen(name);
+        }
+        //Skip empty path segments the same way json_object_get_by_path() does
+        if(end != name && tapeObjectGet(payload->tape, *node, name, (size_t)(end-name), node) == false)
+        {
+            return false;
+        }
+        name = (*end) ? end+1 : end;
+    }
+    return true;
+}
+
+/**
+ * Strings get wrapped in an object and single member objects may be links that get followed, the existing JSON
+ * logic handles both. Everything else can be handed out as a frozen child.
+ */
+static bool frozenNodeNeedsJson(redfishPayload* payload, size_t node)
+{
+    switch(tapeType(payload->tape, node))
+    {
+        case JSON_STRING:
+            return true;
+        case JSON_OBJECT:
+            return (tapeSize(payload->tape, node) == 1);
+        default:
+            return false;
+    }
+}
+
+static redfishPayload* createFrozenChildPayload(redfishPayload* parent, size_t node)
+{
+    redfishPayload* ret = (redfishPayload*)calloc(sizeof(redfishPayload), 1);
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    ret->tape = tapeIncRef(parent->tape);
+    ret->tapeNode = node;
+    ret->service = parent->service;
+    if(ret->service)
+    {
+        serviceIncRef(ret->service);
+    }
+    ret->contentType = PAYLOAD_CONTENT_JSON;
+    return ret;
+}
+
+static bool sharePayloadContent(redfishPayload* payload)
+{
+    if(payload->contentShare == NULL)
+    {
+        payload->contentShare = (struct _payloadContentShare*)malloc(sizeof(struct _payloadContentShare));
+        if(payload->contentShare == NULL)
+        {
+            return false;
+        }
+        payload->contentShare->refCount = 1;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    InterlockedIncrement64(&(payload->contentShare->refCount));
+#else
+    InterlockedIncrement(&(payload->contentShare->refCount));
+#endif
+#else
+    __sync_fetch_and_add(&(payload->contentShare->refCount), 1);
+#endif
+    return true;
+}
+
+static void releasePayloadContent(redfishPayload* payload)
+{
+    size_t newCount = 0;
+
+    if(payload->contentShare)
+    {
+#ifdef _MSC_VER
+#if _M_AMD64
+        newCount = InterlockedDecrement64(&(payload->contentShare->refCount));
+#else
+        newCount = InterlockedDecrement(&(payload->contentShare->refCount));
+#endif
+#else
+        newCount = __sync_sub_and_fetch(&(payload->contentShare->refCount), 1);
+#endif
+        if(newCount == 0)
+        {
+            free(payload->contentShare);
+        }
+    }
+    if(newCount == 0)
+    {
+        free(payload->content);
+    }
+    payload->content = NULL;
+    payload->contentLength = 0;
+    payload->contentShare = NULL;
+}
+
+/*Count the copy as another user of the original's JSON*/
+static bool sharePayloadJson(redfishPayload* original, redfishPayload* copy)
+{
+    if(original->jsonShare == NULL)
+    {
+        original->jsonShare = (struct _payloadJsonShare*)malloc(sizeof(struct _payloadJsonShare));
+        if(original->jsonShare == NULL)
+        {
+            return false;
+        }
+        original->jsonShare->refCount = 1;
+        original->jsonShare->copies = 1;
+        original->jsonShareCopy = true;
+    }
+    copy->jsonShare = original->jsonShare;
+    copy->jsonShareCopy = true;
+#ifdef _MSC_VER
+#if _M_AMD64
+    InterlockedIncrement64(&(copy->jsonShare->refCount));
+    InterlockedIncrement64(&(copy->jsonShare->copies));
+#else
+    InterlockedIncrement(&(copy->jsonShare->refCount));
+    InterlockedIncrement(&(copy->jsonShare->copies));
+#endif
+#else
+    __sync_fetch_and_add(&(copy->jsonShare->refCount), 1);
+    __sync_fetch_and_add(&(copy->jsonShare->copies), 1);
+#endif
+    return true;
+}
+
+static bool isPayloadJsonShared(redfishPayload* payload)
+{
+    return (payload->jsonShare != NULL && payload->jsonShare->copies > 1);
+}
+
+/*Stop using the shared JSON, either because the payload is going away or because it now has a private copy*/
+static void releasePayloadJson(redfishPayload* payload)
+{
+    size_t newCount;
+
+    if(payload->jsonShare == NULL)
+    {
+        return;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    if(payload->jsonShareCopy)
+    {
+        InterlockedDecrement64(&(payload->jsonShare->copies));
+    }
+    newCount = InterlockedDecrement64(&(payload->jsonShare->refCount));
+#else
+    if(payload->jsonShareCopy)
+    {
+        InterlockedDecrement(&(payload->jsonShare->copies));
+    }
+    newCount = InterlockedDecrement(&(payload->jsonShare->refCount));
+#endif
+#else
+    if(payload->jsonShareCopy)
+    {
+        __sync_sub_and_fetch(&(payload->jsonShare->copies), 1);
+    }
+    newCount = __sync_sub_and_fetch(&(payload->jsonShare->refCount), 1);
+#endif
+    if(newCount == 0)
+    {
+        free(payload->jsonShare);
+    }
+    payload->jsonShare = NULL;
+    payload->jsonShareCopy = false;
+}
+
+/**
+ * Make sure no other payload can see changes made to this payload's JSON, copying it first if it lives in an arena
+ * (which is read only) or is shared with a copy of the payload.
+ */
+static bool makePayloadJsonPrivate(redfishPayload* payload)
+{
+    json_t* json = getPayloadJson(payload);
+    json_t* copy;
+
+    if(json == NULL)
+    {
+        return false;
+    }
+    //Children always share the parent's tree, changing them changes the parent too. Only copies need to be kept apart
+    if(payload->arena == NULL && isPayloadJsonShared(payload) == false)
+    {
+        return true;
+    }
+    copy = json_deep_copy(json);
+    if(copy == NULL)
+    {
+        return false;
+    }
+    if(!arenaContains(payload->arena, json))
+    {
+        json_decref(json);
+    }
+    arenaDecRef(payload->arena);
+    payload->arena = NULL;
+    payload->json = copy;
+    releasePayloadJson(payload);
+    return true;
+}
+
+/**
+ * Get a member of an object payload by position. Large objects get a table of their member names the first time, after
+ * which every lookup is a hash lookup instead of a walk from the first member. setPayloadElementByName() drops the
+ * table. The table only holds names, so if the JSON is changed directly a lookup never returns freed memory. A changed
+ * member count or a missing name rebuilds it, but positions may be out of date until one of those happens.
+ */
+static json_t* getObjectMemberByIndex(redfishPayload* payload, size_t index)
+{
+    json_t* json = getPayloadJson(payload);
+    struct _payloadObjectIndex* objIndex = (struct _payloadObjectIndex*)loadPointer((void**)&(payload->objectIndex));
+    json_t* ret;
+    size_t count;
+    size_t namesSize = 0;
+    size_t i;
+    const char* key;
+    json_t* value;
+    char* names;
+
+    count = json_object_size(json);
+    if(index >= count)
+    {
+        return NULL;
+    }
+    if(count < OBJECT_INDEX_MIN_SIZE)
+    {
+        return json_object_get_by_index(json, index);
+    }
+    if(objIndex && objIndex->object == json && objIndex->count == count)
+    {
+        ret = json_object_get(json, objIndex->keys[index]);
+        if(ret)
+        {
+            return ret;
+        }
+    }
+    //Other threads may be reading the payload too, only one builds the table
+    mutex_lock(getPayloadLock(payload));
+    objIndex = payload->objectIndex;
+    if(objIndex && objIndex->object == json && objIndex->count == count)
+    {
+        mutex_unlock(getPayloadLock(payload));
+        return json_object_get(json, objIndex->keys[index]);
+    }
+    if(objIndex)
+    {
+        //Out of date, the object was changed since the table was built
+        freeObjectIndex(payload);
+    }
+
+    json_object_foreach(json, key, value)
+    {
+        namesSize += strlen(key)+1;
+    }
+    objIndex = (struct _payloadObjectIndex*)malloc(sizeof(struct _payloadObjectIndex) + count*sizeof(char*) + namesSize);
+    if(objIndex == NULL)
+    {
+        mutex_unlock(getPayloadLock(payload));
+        return json_object_get_by_index(json, index);
+    }
+    objIndex->object = json;
+    objIndex->count = count;
+    objIndex->keys = (const char**)(objIndex+1);
+    names = (char*)(objIndex->keys + count);
+    i = 0;
+    json_object_foreach(json, key, value)
+    {
+        namesSize = strlen(key)+1;
+        memcpy(names, key, namesSize);
+        objIndex->keys[i++] = names;
+        names += namesSize;
+    }
+    cas(&(payload->objectIndex), NULL, objIndex);
+    mutex_unlock(getPayloadLock(payload));
+    return json_object_get(json, objIndex->keys[index]);
+}
+
+/*Read a pointer another thread may have just published under getPayloadLock(), so that what it points to is seen complete*/
+static void* loadPointer(void** pointer)
+{
+#ifdef _MSC_VER
+    return *((void* volatile*)pointer);
+#else
+    return __atomic_load_n(pointer, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/*The lock for the one time changes made to a payload while reading it, shared by every payload at a similar address*/
+static mutex* getPayloadLock(redfishPayload* payload)
+{
+    return &gPayloadLocks[((uintptr_t)payload / sizeof(redfishPayload)) % PAYLOAD_LOCK_COUNT];
+}
+
+static void freeObjectIndex(redfishPayload* payload)
+{
+    free(payload->objectIndex);
+    payload->objectIndex = NULL;
+}
+
+static json_t* jsonObjectGetSegment(json_t* object, const char* key, size_t keyLength)
+{
+// json_object_getn is only available with Jansson 2.14+.
+// Manually split the keys for compatibility with older versions
+#if JANSSON_VERSION_HEX >= 0x021400
+    return json_object_getn(object, key, keyLength);
+#else
+    char buffer[128];
+    char* subKey = buffer;
+    json_t* ret;
+
+    if(keyLength >= sizeof(buffer))
+    {
+        subKey = calloc(keyLength + 1, sizeof(char));
+        if(subKey == NULL)
+        {
+            return NULL;
+        }
+    }
+    memcpy(subKey, key, keyLength);
+    subKey[keyLength] = '\0';
+    ret = json_object_get(object, subKey);
+    if(subKey != buffer)
+    {
+        free(subKey);
+    }
+    return ret;
+#endif
+}
+
+/**
+ * Walk a compiled path without allocating. On success either json is set (borrowed from the payload) or, for frozen
+ * payloads, node is set.
+ */
+static bool resolvePropertyPath(redfishPayload* payload, const redfishPropertyPath* path, json_t** json, size_t* node)
+{
+    size_t i;
+
+    if(!payload || !path)
+    {
+        return false;
+    }
+    if(isFrozen(payload))
+    {
+        *node = payload->tapeNode;
+        for(i = 0; i < path->segmentCount; i++)
+        {
+            if(tapeObjectGet(payload->tape, *node, path->segments[i].name, path->segments[i].length, node) == false)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    *json = getPayloadJson(payload);
+    for(i = 0; i < path->segmentCount && *json != NULL; i++)
+    {
+#if JANSSON_VERSION_HEX >= 0x021400
+        *json = json_object_getn(*json, path->segments[i].name, path->segments[i].length);
+#else
+        *json = json_object_get(*json, path->segments[i].name);
+#endif
+    }
+    return (*json != NULL);
+}
 /* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -6,6 +6,9 @@
 #include "queue.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#ifndef _MSC_VER
+#include <errno.h>
+#endif
 
 static queueNode* newQueueNode(void* value);
 
@@ -132,6 +135,55 @@ unsigned int queuePopNoWait(queue* q, void** value)
     return 0;
 }
 
+unsigned int queuePopTimeout(queue* q, void** value, unsigned long timeout)
+{
+#ifndef _MSC_VER
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += (time_t)(timeout / 1000000);
+    ts.tv_nsec += (long)(timeout % 1000000) * 1000;
+    if(ts.tv_nsec >= 1000000000)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+#endif
+    mutex_lock(&q->popLock);
+    while(q->divider == q->last)
+    {
+#ifdef _MSC_VER
+        if(SleepConditionVariableSRW(&q->pushed, &q->popLock, (DWORD)((timeout + 999) / 1000), 0) == FALSE)
+        {
+            break;
+        }
+#else
+        if(pthread_cond_timedwait(&q->pushed, &q->popLock, &ts) == ETIMEDOUT)
+        {
+            break;
+        }
+#endif
+    }
+    if(q->divider == q->last)
+    {
+        mutex_unlock(&q->popLock);
+        return 1;
+    }
+    *value = q->divider->next->value;
+    if(cas(&q->divider, q->divider, q->divider->next) == false)
+    {
+        //Try once more...
+        if(cas(&q->divider, q->divider, q->divider->next) == false)
+        {
+            //Didn't really pop...
+            mutex_unlock(&q->popLock);
+            return 1;
+        }
+    }
+    mutex_unlock(&q->popLock);
+    return 0;
+}
+
 static queueNode* newQueueNode(void* value)
 {
     queueNode* ret = malloc(sizeof(queueNode));
@@ -28,6 +28,8 @@
 /** A thread return type, the OS specific return type expected by a thread **/
 #define threadRet         DWORD
 
+/** Statically initialize a mutex **/
+#define mutex_initializer SRWLOCK_INIT
 /** Initialize a mutex **/
 #define mutex_init        InitializeSRWLock
 /** Lock a mutex **/
@@ -76,6 +78,8 @@ inline bool cas(void* ptr, void* comp, void* replace)
 /** A thread return type, the OS specific return type expected by a thread **/
 #define threadRet         void*
 
+/** Statically initialize a mutex **/
+#define mutex_initializer PTHREAD_MUTEX_INITIALIZER
 /** Initialize a mutex **/
 #define mutex_init(m)     pthread_mutex_init((m), NULL)
 /** Lock a mutex **/
@@ -238,6 +242,19 @@ unsigned int queuePop(queue* q, void** value);
  * @see queuePop
  */
 unsigned int queuePopNoWait(queue* q, void** value);
+/**
+ * @brief Remove an element from the queue.
+ *
+ *  Wait up to the timeout for an element to be available and then remove it from the queue.
+ *
+ * @param q The queue to remove from.
+ * @param value A pointer to the value obtained
+ * @param timeout The longest time to wait in microseconds
+ * @return 0 on success, non-zero on failure or no element present by the timeout
+ * @see queuePush
+ * @see queuePop
+ */
+unsigned int queuePopTimeout(queue* q, void** value, unsigned long timeout);
 
 #endif
 /* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -5,13 +5,56 @@
 //----------------------------------------------------------------------------
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <jansson.h>
 
 #include <redpath.h>
+#include "internal_redpath.h"
+#include "queue.h"
 #include "util.h"
 #include "debug.h"
 
+struct _redPathPlan
+{
+    /** The number of users of this plan, the cache counts as one **/
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 refCount;
+#else
+    LONG refCount;
+#endif
+#else
+    size_t refCount;
+#endif
+    /** The parsed path, never changed once the plan is built **/
+    redPathNode* nodes;
+    /** The path string for plans in the cache, NULL otherwise **/
+    char* path;
+    /** The next more recently used plan in the cache **/
+    struct _redPathPlan* newer;
+    /** The next less recently used plan in the cache **/
+    struct _redPathPlan* older;
+};
+
 static char* getVersion(const char* path, char** end);
 static void parseNode(const char* path, redPathNode* node, redPathNode** end);
+static redPathPlan* newPlan(redPathNode* nodes);
+static redPathPlan* findCachedPlan(const char* path);
+static void unlinkCachedPlan(redPathPlan* plan);
+static void trimPlanCache(size_t size);
+
+static bool gPlanCacheInitialized = false;
+static mutex gPlanCacheLock;
+/** The most plans to keep, 0 when the cache is off **/
+static size_t gPlanCacheSize = 0;
+/** The number of plans in the cache **/
+static size_t gPlanCacheCount = 0;
+/** The cached plans keyed by path, each value holds the plan's address **/
+static json_t* gPlanIndex = NULL;
+/** The most recently used plan **/
+static redPathPlan* gNewestPlan = NULL;
+/** The least recently used plan, the next to be dropped **/
+static redPathPlan* gOldestPlan = NULL;
 
 redPathNode* parseRedPath(const char* path)
 {
@@ -96,6 +139,148 @@ void cleanupRedPath(redPathNode* node)
     free(node);
 }
 
+redPathPlan* redpathPlanGet(const char* path)
+{
+    redPathPlan* plan;
+    redPathPlan* existing;
+    redPathNode* nodes;
+
+    if(path == NULL)
+    {
+        return NULL;
+    }
+    if(gPlanCacheSize == 0)
+    {
+        nodes = parseRedPath(path);
+        plan = newPlan(nodes);
+        if(plan == NULL)
+        {
+            cleanupRedPath(nodes);
+        }
+        return plan;
+    }
+    mutex_lock(&gPlanCacheLock);
+    plan = findCachedPlan(path);
+    mutex_unlock(&gPlanCacheLock);
+    if(plan)
+    {
+        return plan;
+    }
+    //Parse outside the lock, other paths can be looked up meanwhile
+    nodes = parseRedPath(path);
+    plan = newPlan(nodes);
+    if(plan == NULL)
+    {
+        cleanupRedPath(nodes);
+        return NULL;
+    }
+    plan->path = safeStrdup(path);
+    if(plan->path == NULL)
+    {
+        return plan;
+    }
+    mutex_lock(&gPlanCacheLock);
+    existing = findCachedPlan(path);
+    if(existing == NULL && gPlanCacheSize != 0 && json_object_set_new(gPlanIndex, path, json_integer((json_int_t)(intptr_t)plan)) == 0)
+    {
+        //One reference for the cache, one for the caller
+        redpathPlanIncRef(plan);
+        plan->older = gNewestPlan;
+        if(gNewestPlan)
+        {
+            gNewestPlan->newer = plan;
+        }
+        gNewestPlan = plan;
+        if(gOldestPlan == NULL)
+        {
+            gOldestPlan = plan;
+        }
+        gPlanCacheCount++;
+        trimPlanCache(gPlanCacheSize);
+    }
+    mutex_unlock(&gPlanCacheLock);
+    if(existing)
+    {
+        //Another thread cached the same path first
+        redpathPlanDecRef(plan);
+        return existing;
+    }
+    return plan;
+}
+
+redPathPlan* redpathPlanWrap(redPathNode* nodes)
+{
+    return newPlan(nodes);
+}
+
+redPathNode* redpathPlanUnwrap(redPathPlan* plan)
+{
+    redPathNode* nodes = plan->nodes;
+
+    plan->nodes = NULL;
+    redpathPlanDecRef(plan);
+    return nodes;
+}
+
+redPathNode* redpathPlanNodes(redPathPlan* plan)
+{
+    return plan->nodes;
+}
+
+redPathPlan* redpathPlanIncRef(redPathPlan* plan)
+{
+#ifdef _MSC_VER
+#if _M_AMD64
+    InterlockedIncrement64(&(plan->refCount));
+#else
+    InterlockedIncrement(&(plan->refCount));
+#endif
+#else
+    __sync_fetch_and_add(&(plan->refCount), 1);
+#endif
+    return plan;
+}
+
+void redpathPlanDecRef(redPathPlan* plan)
+{
+    size_t newCount;
+
+    if(plan == NULL)
+    {
+        return;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    newCount = InterlockedDecrement64(&(plan->refCount));
+#else
+    newCount = InterlockedDecrement(&(plan->refCount));
+#endif
+#else
+    newCount = __sync_sub_and_fetch(&(plan->refCount), 1);
+#endif
+    if(newCount != 0)
+    {
+        return;
+    }
+    cleanupRedPath(plan->nodes);
+    free(plan->path);
+    free(plan);
+}
+
+void redpathCacheSetSize(size_t size)
+{
+    if(gPlanCacheInitialized == false)
+    {
+        mutex_init(&gPlanCacheLock);
+        gPlanIndex = json_object();
+        gPlanCacheInitialized = true;
+    }
+    mutex_lock(&gPlanCacheLock);
+    gPlanCacheSize = size;
+    trimPlanCache(size);
+    mutex_unlock(&gPlanCacheLock);
+}
+
 static char* getVersion(const char* path, char** end)
 {
     return getStringTill(path, "/", end);
@@ -228,4 +413,92 @@ static void parseNode(const char* path, redPathNode* node, redPathNode** end)
 #endif
     free(index);
 }
+static redPathPlan* newPlan(redPathNode* nodes)
+{
+    redPathPlan* plan;
+
+    if(nodes == NULL)
+    {
+        return NULL;
+    }
+    plan = (redPathPlan*)calloc(1, sizeof(redPathPlan));
+    if(plan == NULL)
+    {
+        return NULL;
+    }
+    plan->refCount = 1;
+    plan->nodes = nodes;
+    return plan;
+}
+
+/*Called with the cache lock held, returns a new reference to the plan and marks it most recently used*/
+static redPathPlan* findCachedPlan(const char* path)
+{
+    redPathPlan* plan;
+    json_t* entry;
+
+    entry = json_object_get(gPlanIndex, path);
+    if(entry == NULL)
+    {
+        return NULL;
+    }
+    plan = (redPathPlan*)(intptr_t)json_integer_value(entry);
+    if(plan != gNewestPlan)
+    {
+        //Move the plan to the front of the list, the index entry stays as it is
+        plan->newer->older = plan->older;
+        if(plan->older)
+        {
+            plan->older->newer = plan->newer;
+        }
+        else
+        {
+            gOldestPlan = plan->newer;
+        }
+        plan->newer = NULL;
+        plan->older = gNewestPlan;
+        gNewestPlan->newer = plan;
+        gNewestPlan = plan;
+    }
+    return redpathPlanIncRef(plan);
+}
+
+/*Called with the cache lock held, the cache's reference is left to the caller*/
+static void unlinkCachedPlan(redPathPlan* plan)
+{
+    if(plan->newer)
+    {
+        plan->newer->older = plan->older;
+    }
+    else
+    {
+        gNewestPlan = plan->older;
+    }
+    if(plan->older)
+    {
+        plan->older->newer = plan->newer;
+    }
+    else
+    {
+        gOldestPlan = plan->newer;
+    }
+    plan->newer = NULL;
+    plan->older = NULL;
+    json_object_del(gPlanIndex, plan->path);
+    gPlanCacheCount--;
+}
+
+/*Called with the cache lock held*/
+static void trimPlanCache(size_t size)
+{
+    redPathPlan* plan;
+
+    while(gPlanCacheCount > size)
+    {
+        plan = gOldestPlan;
+        unlinkCachedPlan(plan);
+        //Traversals still using the plan keep it alive
+        redpathPlanDecRef(plan);
+    }
+}
 /* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -6,12 +6,18 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <time.h>
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
 
 #include "internal_service.h"
+#include "internal_payload.h"
+#include "internal_snapshot.h"
+#include "pathMemo.h"
+#include "arena.h"
 #include "asyncEvent.h"
+#include "odataQuery.h"
 #include <redfishService.h>
 #include <redfishPayload.h>
 #include <redpath.h>
@@ -37,7 +43,17 @@ struct EventActorState
 /** Default asynchronous options for Redfish calls **/
 redfishAsyncOptions gDefaultOptions = {
     .accept = REDFISH_ACCEPT_JSON,
-    .timeout = 20
+    .timeout = 20,
+    .bodyHandling = REDFISH_BODY_PARSE,
+    .flags = 0
+};
+
+/** Options for internal calls that only care about the status of the operation **/
+static redfishAsyncOptions gSkipBodyOptions = {
+    .accept = REDFISH_ACCEPT_JSON,
+    .timeout = 20,
+    .bodyHandling = REDFISH_BODY_SKIP,
+    .flags = 0
 };
 
 static redfishService* createServiceEnumeratorNoAuth(const char* host, const char* rootUri, bool enumerate, unsigned int flags);
@@ -46,11 +62,13 @@ static redfishService* createServiceEnumeratorSessionAuth(const char* host, cons
 static redfishService* createServiceEnumeratorExistingSessionAuth(const char* host, const char* rootUri, const char* token, const char* sessionUri, unsigned int flags);
 static redfishService* createServiceEnumeratorToken(const char* host, const char* rootUri, const char* token, unsigned int flags);
 static char* makeUrlForService(redfishService* service, const char* uri);
+static char* makeQueryUrlForService(redfishService* service, const char* uri, redfishAsyncOptions* options, unsigned int* local);
+static void recordServiceFeatures(redfishService* service, json_t* root);
 static json_t* getVersions(redfishService* service, const char* rootUri);
 static char* getSSEUri(redfishService* service);
 static char* getEventSubscriptionUri(redfishService* service);
 static void addStringToJsonObject(json_t* object, const char* key, const char* value);
-static redfishPayload* getPayloadFromAsyncResponse(asyncHttpResponse* response, redfishService* service);
+static redfishPayload* getPayloadFromAsyncResponse(asyncHttpResponse* response, redfishService* service, redfishAsyncOptions* options);
 static unsigned char* base64_encode(const unsigned char* src, size_t len, size_t* out_len);
 static bool createServiceEnumeratorNoAuthAsync(const char* host, const char* rootUri, unsigned int flags, redfishCreateAsyncCallback callback, void* context);
 static bool createServiceEnumeratorBasicAuthAsync(const char* host, const char* rootUri, const char* username, const char* password, unsigned int flags, redfishCreateAsyncCallback callback, void* context);
@@ -61,6 +79,28 @@ static bool getVersionsAsync(redfishService* service, const char* rootUri, redfi
 static char* getDestinationAddress(const char* addressInfo, SOCKET* socket);
 static void freeServicePtr(redfishService* service);
 
+typedef struct _pathBatch pathBatch;
+typedef struct _pathBatchNode pathBatchNode;
+static pathBatchNode* pathBatchAddStep(pathBatch* batch, pathBatchNode*** list, size_t* listCount, redPathNode* step);
+static bool pathBatchStepEqual(redPathNode* a, redPathNode* b);
+static bool pathBatchStringEqual(const char* a, const char* b);
+static void gotPathBatchPayload(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static void pathBatchFail(pathBatchNode* node, bool success, unsigned short httpCode, redfishPayload* payload);
+static void pathBatchDecRef(pathBatch* batch);
+static void pathBatchStartFailed(void* context);
+static void pathBatchRelease(void* context);
+static void pathBatchFree(pathBatch* batch);
+static void pathBatchFreeNodes(pathBatchNode** list, size_t listCount);
+static redfishAsyncOptions* pathBatchOptions(pathBatchNode* node);
+static void gotMemoResourceAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static char* getMemoUriForPath(redfishService* service, redPathNode* redpath, redPathNode** resume);
+static bool serviceRootCacheable(redfishAsyncOptions* options);
+static json_t* getCachedServiceRoot(redfishService* service, const char* uri);
+static void cacheServiceRoot(redfishService* service, const char* uri, json_t* root);
+static void gotServiceRootForCache(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+static void gotReplayedUri(void* context);
+static bool replayUriFromService(redfishService* service, const char* uri, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context);
+
 redfishService* createServiceEnumerator(const char* host, const char* rootUri, enumeratorAuthentication* auth, unsigned int flags)
 {
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. host = %s, rootUri = %s, auth = %p, flags = %x\n", __func__, host, rootUri, auth, flags);
@@ -147,7 +187,7 @@ static void cleanupAsyncToSyncContext(asyncToSyncContext* context)
     }
 }
 
-static bool isOnAsyncThread(redfishService* service)
+bool isOnAsyncThread(redfishService* service)
 {
     if(service == NULL)
     {
@@ -171,7 +211,7 @@ void asyncToSyncConverter(bool success, unsigned short httpCode, redfishPayload*
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %d, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
     myContext->success = success;
     myContext->data = payload;
-    if(payload != NULL && payload->content != NULL)
+    if(payload != NULL && payload->contentType != PAYLOAD_CONTENT_JSON && payload->content != NULL)
     {
         content = malloc(payload->contentLength+1);
         if(content)
@@ -223,7 +263,7 @@ json_t* getUriFromService(redfishService* service, const char* uri)
     cond_wait(&context->waitForIt, &context->spinLock);
     if(context->data)
     {
-        json = json_incref(context->data->json);
+        json = json_incref(getPayloadJson(context->data));
     }
     else
     {
@@ -279,7 +319,7 @@ json_t* patchUriFromService(redfishService* service, const char* uri, const char
     cond_wait(&context->waitForIt, &context->spinLock);
     if(context->data)
     {
-        json = json_incref(context->data->json);
+        json = json_incref(getPayloadJson(context->data));
     }
     else
     {
@@ -335,7 +375,7 @@ json_t* postUriFromService(redfishService* service, const char* uri, const char*
     cond_wait(&context->waitForIt, &context->spinLock);
     if(context->data)
     {
-        json = json_incref(context->data->json);
+        json = json_incref(getPayloadJson(context->data));
     }
     else
     {
@@ -378,7 +418,8 @@ bool deleteUriFromService(redfishService* service, const char* uri)
         return false;
     }
     context->refcount++;
-    tmp = deleteUriFromServiceAsync(service, uri, NULL, asyncToSyncConverter, context);
+    //Nothing looks at the response body, don't bother parsing it
+    tmp = deleteUriFromServiceAsync(service, uri, &gSkipBodyOptions, asyncToSyncConverter, context);
     if(tmp == false)
     {
         REDFISH_DEBUG_ERR_PRINT("%s: Async call failed immediately...\n", __func__);
@@ -435,8 +476,56 @@ typedef struct
     redfishAsyncOptions* originalOptions;
     /** The redfish service the call was made on **/
     redfishService*      service;
+    /** The SERVICE_FEATURE_* query options the service did not do and need to be applied to the response **/
+    unsigned int         localQuery;
+    /** The URI to answer from the snapshot of a replay service, NULL if the request goes through the raw async calls **/
+    char*                replayUri;
+    /** True for GET requests, only their responses are read page by page or cut to maxMembers **/
+    bool                 isGet;
 } rawAsyncCallbackContextWrapper;
 
+/** The context used to read the service root before a request with query options **/
+typedef struct
+{
+    /** The URI the caller asked for **/
+    char*                uri;
+    /** The caller's options **/
+    redfishAsyncOptions* options;
+    /** The caller's callback **/
+    redfishAsyncCallback callback;
+    /** The caller's context **/
+    void*                originalContext;
+    /** The redfish service the call was made on **/
+    redfishService*      service;
+} queryFeaturesContext;
+
+/** The context used to read the remaining pages of a collection **/
+typedef struct
+{
+    /** The collection read so far **/
+    redfishPayload*      collection;
+    /** The number of members in collection **/
+    size_t               memberCount;
+    /** The HTTP status of the first page **/
+    unsigned short       httpCode;
+    /** The redfish style callback to call once every page has been read **/
+    redfishAsyncCallback callback;
+    /** The original caller provided context to pass to the callback **/
+    void*                originalContext;
+    /** The original options passed to the call **/
+    redfishAsyncOptions* originalOptions;
+    /** The options for reading the pages, the query options are already in the next links **/
+    redfishAsyncOptions  pageOptions;
+    /** The SERVICE_FEATURE_* query options to apply once every page has been read **/
+    unsigned int         localQuery;
+    /** Set if a page could not be added to the collection **/
+    bool                 failed;
+    /** The redfish service the call was made on **/
+    redfishService*      service;
+} collectionPagingContext;
+
+static void gotCollectionPage(bool success, unsigned short httpCode, redfishPayload* payload, void* context);
+
 static bool isRedirectCode(unsigned short httpCode)
 {
     if(httpCode == 201 || httpCode == 202 || (httpCode >= 300 && httpCode < 400))
@@ -446,12 +535,155 @@ static bool isRedirectCode(unsigned short httpCode)
     return false;
 }
 
+static void finishCollectionPaging(collectionPagingContext* myContext, bool success, unsigned short httpCode)
+{
+    if(myContext->failed)
+    {
+        success = false;
+        httpCode = 0xFFFF;
+    }
+    //The collection holds its own reference to the service
+    serviceDecRef(myContext->service);
+    if(success && myContext->localQuery)
+    {
+        odataQueryApplyLocally(myContext->collection, myContext->originalOptions, myContext->localQuery, myContext->httpCode, myContext->callback, myContext->originalContext);
+    }
+    else
+    {
+        myContext->callback(success, (success) ? myContext->httpCode : httpCode, myContext->collection, myContext->originalContext);
+    }
+    free(myContext);
+}
+
+/**
+ * Ask for the next page, if any, before adding this page's members to the collection so that the service is working on
+ * the next page while this one is parsed.
+ */
+static bool getNextCollectionPage(collectionPagingContext* myContext, redfishPayload* page)
+{
+    char* nextLink;
+    bool ret = false;
+
+    if(myContext->originalOptions->maxMembers && myContext->memberCount >= myContext->originalOptions->maxMembers)
+    {
+        return false;
+    }
+    nextLink = getPayloadNextLink(page);
+    if(nextLink)
+    {
+        ret = getUriFromServiceAsync(myContext->service, nextLink, &myContext->pageOptions, gotCollectionPage, myContext);
+        if(ret == false)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to get next page %s\n", __func__, nextLink);
+            myContext->failed = true;
+        }
+        free(nextLink);
+    }
+    return ret;
+}
+
+static void gotCollectionPage(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    collectionPagingContext* myContext = (collectionPagingContext*)context;
+    bool more;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    if(success == false || httpCode >= 300 || payload == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to get collection page, http code %u\n", __func__, httpCode);
+        cleanupPayload(payload);
+        finishCollectionPaging(myContext, false, httpCode);
+        return;
+    }
+    more = getNextCollectionPage(myContext, payload);
+    if(appendCollectionPage(myContext->collection, payload, myContext->originalOptions->maxMembers) == false)
+    {
+        myContext->failed = true;
+    }
+    myContext->memberCount = json_array_size(json_object_get(getPayloadJson(myContext->collection), "Members"));
+    cleanupPayload(payload);
+    if(more == false)
+    {
+        finishCollectionPaging(myContext, true, 200);
+    }
+}
+
+static bool startCollectionPaging(rawAsyncCallbackContextWrapper* wrapper, redfishAsyncOptions* options, redfishPayload* payload, unsigned short httpCode)
+{
+    collectionPagingContext* myContext;
+    char* nextLink;
+    bool more;
+
+    if(options->flags & REDFISH_ASYNC_FLAG_NO_PAGING)
+    {
+        return false;
+    }
+    nextLink = getPayloadNextLink(payload);
+    if(nextLink == NULL)
+    {
+        return false;
+    }
+    free(nextLink);
+    myContext = (collectionPagingContext*)calloc(1, sizeof(collectionPagingContext));
+    if(myContext == NULL)
+    {
+        return false;
+    }
+    myContext->collection = payload;
+    myContext->httpCode = httpCode;
+    myContext->callback = wrapper->callback;
+    myContext->originalContext = wrapper->originalContext;
+    myContext->originalOptions = options;
+    myContext->pageOptions.accept = options->accept;
+    myContext->pageOptions.timeout = options->timeout;
+    myContext->pageOptions.bodyHandling = options->bodyHandling;
+    myContext->pageOptions.flags = options->flags | REDFISH_ASYNC_FLAG_NO_PAGING;
+    myContext->localQuery = wrapper->localQuery;
+    myContext->service = wrapper->service;
+    serviceIncRef(myContext->service);
+    more = getNextCollectionPage(myContext, payload);
+    //Applies maxMembers to the first page, parsing it while the next page is on its way
+    if(appendCollectionPage(payload, NULL, options->maxMembers) == false)
+    {
+        myContext->failed = true;
+    }
+    myContext->memberCount = json_array_size(json_object_get(getPayloadJson(payload), "Members"));
+    if(more == false)
+    {
+        finishCollectionPaging(myContext, true, 200);
+    }
+    return true;
+}
+
+/*Read any further pages and apply any local query options before handing the payload to the caller*/
+static void finishRedfishCallback(rawAsyncCallbackContextWrapper* myContext, redfishAsyncOptions* options, bool success, unsigned short httpCode, redfishPayload* payload)
+{
+    if(success && payload && myContext->isGet && options->maxMembers && isPayloadCollection(payload))
+    {
+        appendCollectionPage(payload, NULL, options->maxMembers);
+    }
+    if(success && payload && myContext->isGet && startCollectionPaging(myContext, options, payload, httpCode))
+    {
+        //The callback is called once every page has been read
+    }
+    else if(success && payload && myContext->localQuery)
+    {
+        odataQueryApplyLocally(payload, options, myContext->localQuery, httpCode, myContext->callback, myContext->originalContext);
+    }
+    else
+    {
+        myContext->callback(success, httpCode, payload, myContext->originalContext);
+    }
+}
+
 static void rawCallbackWrapper(asyncHttpRequest* request, asyncHttpResponse* response, void* context)
 {
     bool success = false;
     rawAsyncCallbackContextWrapper* myContext = (rawAsyncCallbackContextWrapper*)context;
-    redfishPayload* payload;
+    redfishPayload* payload = NULL;
     httpHeader* header;
+    redfishAsyncOptions* options = myContext->originalOptions;
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. request = %p, response = %p, context = %p\n", __func__, request, response, context);
 
@@ -485,17 +717,29 @@ static void rawCallbackWrapper(asyncHttpRequest* request, asyncHttpResponse* res
         {
             success = true;
         }
-        payload = getPayloadFromAsyncResponse(response, myContext->service);
-        if(payload == NULL)
+        if(options == NULL)
+        {
+            options = &gDefaultOptions;
+        }
+        //When skipping the body the caller only cares about the status, so a missing payload isn't an error
+        if(options->bodyHandling != REDFISH_BODY_SKIP)
         {
-            success = false;
-            if(response->httpResponseCode == 200)
+            payload = getPayloadFromAsyncResponse(response, myContext->service, options);
+            if(payload == NULL)
             {
-                //Override with an error code indicating parsing issues.
-                response->httpResponseCode = REDFISH_ERROR_PARSING;
+                success = false;
+                if(response->httpResponseCode == 200)
+                {
+                    //Override with an error code indicating parsing issues.
+                    response->httpResponseCode = REDFISH_ERROR_PARSING;
+                }
             }
         }
-        myContext->callback(success, (unsigned short)response->httpResponseCode, payload, myContext->originalContext);
+        if(payload)
+        {
+            payload->responseTime = response->responseTime;
+        }
+        finishRedfishCallback(myContext, options, success, (unsigned short)response->httpResponseCode, payload);
     }
     freeAsyncRequest(request);
     freeAsyncResponse(response);
@@ -574,18 +818,147 @@ bool createServiceEnumeratorAsync(const char* host, const char* rootUri, enumera
     }
 }
 
+static void gotServiceRootForFeatures(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    queryFeaturesContext* myContext = (queryFeaturesContext*)context;
+
+    if(success && httpCode < 300 && payload)
+    {
+        recordServiceFeatures(myContext->service, getPayloadJson(payload));
+    }
+    else
+    {
+        REDFISH_DEBUG_WARNING_PRINT("%s: Unable to read service root, applying query options locally\n", __func__);
+        myContext->service->protocolFeatures = SERVICE_FEATURES_KNOWN;
+    }
+    cleanupPayload(payload);
+    if(getUriFromServiceAsync(myContext->service, myContext->uri, myContext->options, myContext->callback, myContext->originalContext) == false)
+    {
+        myContext->callback(false, 0xFFFF, NULL, myContext->originalContext);
+    }
+    serviceDecRef(myContext->service);
+    free(myContext->uri);
+    free(myContext);
+}
+
+static bool getServiceFeaturesThenUri(redfishService* service, const char* uri, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    queryFeaturesContext* myContext;
+
+    myContext = (queryFeaturesContext*)malloc(sizeof(queryFeaturesContext));
+    if(myContext == NULL)
+    {
+        return false;
+    }
+    myContext->uri = safeStrdup(uri);
+    if(myContext->uri == NULL)
+    {
+        free(myContext);
+        return false;
+    }
+    myContext->options = options;
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->service = service;
+    serviceIncRef(service);
+    if(getRedfishServiceRootAsync(service, NULL, &gDefaultOptions, gotServiceRootForFeatures, myContext) == false)
+    {
+        //No service root to read, so don't try again
+        service->protocolFeatures = SERVICE_FEATURES_KNOWN;
+        serviceDecRef(service);
+        free(myContext->uri);
+        free(myContext);
+        return getUriFromServiceAsync(service, uri, options, callback, context);
+    }
+    return true;
+}
+
+/*Answer a GET from the snapshot on the async thread, handing over the stored payload as is*/
+static void gotReplayedUri(void* context)
+{
+    rawAsyncCallbackContextWrapper* myContext = (rawAsyncCallbackContextWrapper*)context;
+    redfishAsyncOptions* options = myContext->originalOptions;
+    redfishPayload* payload;
+    bool success;
+
+    if(options == NULL)
+    {
+        options = &gDefaultOptions;
+    }
+    payload = replaySnapshotUri(myContext->service, myContext->replayUri);
+    success = (payload != NULL);
+    REDFISH_DEBUG_NOTICE_PRINT("%s: Replayed uri %s with code %u\n", __func__, myContext->replayUri, success ? 200 : 404);
+    if(options->bodyHandling == REDFISH_BODY_SKIP || myContext->callback == NULL)
+    {
+        cleanupPayload(payload);
+        payload = NULL;
+    }
+    if(myContext->callback)
+    {
+        finishRedfishCallback(myContext, options, success, success ? 200 : 404, payload);
+    }
+    serviceDecRef(myContext->service);
+    free(myContext->replayUri);
+    free(myContext);
+}
+
+static bool replayUriFromService(redfishService* service, const char* uri, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    rawAsyncCallbackContextWrapper* myContext;
+
+    myContext = malloc(sizeof(rawAsyncCallbackContextWrapper));
+    if(myContext == NULL)
+    {
+        return false;
+    }
+    myContext->replayUri = safeStrdup(uri);
+    if(myContext->replayUri == NULL)
+    {
+        free(myContext);
+        return false;
+    }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->originalOptions = options;
+    myContext->service = service;
+    myContext->isGet = true;
+    //The snapshot only holds whole resources, so every query option is applied here
+    myContext->localQuery = odataQueryRequested(options);
+    serviceIncRef(service);
+    //Answer when the service would have, other requests are answered in the meantime
+    if(queueDelayedAsyncWork(service, gotReplayedUri, myContext, replaySnapshotDelay(service, uri)) == false)
+    {
+        serviceDecRef(service);
+        free(myContext->replayUri);
+        free(myContext);
+        return false;
+    }
+    return true;
+}
+
 bool getUriFromServiceAsync(redfishService* service, const char* uri, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
 {
     char* url;
     asyncHttpRequest* request;
     rawAsyncCallbackContextWrapper* myContext;
+    unsigned int localQuery = 0;
     bool ret;
 
     REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. service = %p, uri = %s, options = %p, callback = %p, context = %p\n", __func__, service, uri, options, callback, context);
 
+    if(service->replay)
+    {
+        return replayUriFromService(service, uri, options, callback, context);
+    }
+    if(odataQueryRequested(options) && !(service->protocolFeatures & SERVICE_FEATURES_KNOWN))
+    {
+        //Which query options the service can do comes from the service root, read that first
+        return getServiceFeaturesThenUri(service, uri, options, callback, context);
+    }
+
     serviceIncRef(service);
 
-    url = makeUrlForService(service, uri);
+    url = makeQueryUrlForService(service, uri, options, &localQuery);
     if(!url)
     {
         REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not make url for uri %s\n", __func__, uri);
@@ -615,6 +988,9 @@ bool getUriFromServiceAsync(redfishService* service, const char* uri, redfishAsy
     myContext->originalContext = context;
     myContext->originalOptions = options;
     myContext->service = service;
+    myContext->localQuery = localQuery;
+    myContext->replayUri = NULL;
+    myContext->isGet = true;
     ret = startRawAsyncRequest(service, request, rawCallbackWrapper, myContext);
     if(ret == false)
     {
@@ -674,6 +1050,9 @@ bool patchUriFromServiceAsync(redfishService* service, const char* uri, redfishP
     myContext->originalContext = context;
     myContext->originalOptions = options;
     myContext->service = service;
+    myContext->localQuery = 0;
+    myContext->replayUri = NULL;
+    myContext->isGet = false;
     ret = startRawAsyncRequest(service, request, rawCallbackWrapper, myContext);
     if(ret == false)
     {
@@ -722,6 +1101,59 @@ bool postUriFromServiceAsync(redfishService* service, const char* uri, redfishPa
     myContext->originalContext = context;
     myContext->originalOptions = options;
     myContext->service = service;
+    myContext->localQuery = 0;
+    myContext->replayUri = NULL;
+    myContext->isGet = false;
+    ret = startRawAsyncRequest(service, request, rawCallbackWrapper, myContext);
+    if(ret == false)
+    {
+        free(myContext);
+    }
+    return ret;
+}
+
+bool deleteUriFromServiceAsync(redfishService* service, const char* uri, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    char* url;
+    asyncHttpRequest* request;
+    rawAsyncCallbackContextWrapper* myContext;
+    bool ret;
+
+    serviceIncRef(service);
+
+    url = makeUrlForService(service, uri);
+    if(!url)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not make url for uri %s\n", __func__, uri);
+        serviceDecRef(service);
+        return false;
+    }
+
+    request = createRequest(url, HTTP_DELETE, 0, NULL);
+    free(url);
+    if(request == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not allocate request structure\n", __func__);
+        serviceDecRef(service);
+        return false;
+    }
+    setupRequestFromOptions(request, service, options);
+
+    myContext = malloc(sizeof(rawAsyncCallbackContextWrapper));
+    if(myContext == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not allocate context.\n", __func__);
+        freeAsyncRequest(request);
+        serviceDecRef(service);
+        return false;
+    }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->originalOptions = options;
+    myContext->service = service;
+    myContext->localQuery = 0;
+    myContext->replayUri = NULL;
+    myContext->isGet = false;
     ret = startRawAsyncRequest(service, request, rawCallbackWrapper, myContext);
     if(ret == false)
     {
@@ -730,158 +1162,735 @@ bool postUriFromServiceAsync(redfishService* service, const char* uri, redfishPa
     return ret;
 }
 
-bool deleteUriFromServiceAsync(redfishService* service, const char* uri, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+/** Internal structure used to cache the service root once it arrives **/
+typedef struct
+{
+    /** The original callback **/
+    redfishAsyncCallback callback;
+    /** The original context for the original callback **/
+    void* originalContext;
+    /** The service the root was requested from **/
+    redfishService* service;
+    /** The URI of the service root **/
+    char* uri;
+    /** The cached root to deliver, NULL while the root is read from the service **/
+    redfishPayload* payload;
+} rootCacheContext;
+
+void setServiceRootLifetime(redfishService* service, unsigned int seconds)
+{
+    if(service == NULL)
+    {
+        return;
+    }
+    mutex_lock(&service->rootCacheLock);
+    service->rootLifetime = seconds;
+    mutex_unlock(&service->rootCacheLock);
+}
+
+void invalidateServiceRoot(redfishService* service)
+{
+    if(service == NULL)
+    {
+        return;
+    }
+    mutex_lock(&service->rootCacheLock);
+    json_decref(service->rootCache);
+    service->rootCache = NULL;
+    mutex_unlock(&service->rootCacheLock);
+}
+
+/*Only plain requests for the whole root are answered from or saved to the cache*/
+static bool serviceRootCacheable(redfishAsyncOptions* options)
+{
+    if(options == NULL)
+    {
+        return true;
+    }
+    if(options->accept != 0 && (options->accept & REDFISH_ACCEPT_JSON) == 0)
+    {
+        return false;
+    }
+    return (options->bodyHandling != REDFISH_BODY_SKIP && options->select == NULL && options->filter == NULL && options->top == 0 && options->skip == 0);
+}
+
+static json_t* getCachedServiceRoot(redfishService* service, const char* uri)
+{
+    json_t* entry;
+    json_t* ret = NULL;
+
+    mutex_lock(&service->rootCacheLock);
+    entry = json_object_get(service->rootCache, uri);
+    if(entry)
+    {
+        if(service->rootLifetime == 0 || json_integer_value(json_object_get(entry, "read")) + service->rootLifetime > (json_int_t)time(NULL))
+        {
+            ret = json_incref(json_object_get(entry, "root"));
+        }
+        else
+        {
+            json_object_del(service->rootCache, uri);
+        }
+    }
+    mutex_unlock(&service->rootCacheLock);
+    return ret;
+}
+
+static void cacheServiceRoot(redfishService* service, const char* uri, json_t* root)
+{
+    json_t* copy;
+
+    if(!json_is_object(root))
+    {
+        return;
+    }
+    //The payload's tree may live in an arena, so keep a copy of our own. Payloads made from it share it until they change it
+    copy = json_deep_copy(root);
+    if(copy == NULL)
+    {
+        return;
+    }
+    mutex_lock(&service->rootCacheLock);
+    if(service->rootCache == NULL && service->freeing == false)
+    {
+        service->rootCache = json_object();
+    }
+    if(service->rootCache)
+    {
+        json_object_set_new(service->rootCache, uri, json_pack("{s:o,s:I}", "root", copy, "read", (json_int_t)time(NULL)));
+        copy = NULL;
+    }
+    mutex_unlock(&service->rootCacheLock);
+    json_decref(copy);
+}
+
+static void gotServiceRootForCache(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    rootCacheContext* myContext = (rootCacheContext*)context;
+
+    if(success && httpCode < 300 && payload && payload->contentType == PAYLOAD_CONTENT_JSON)
+    {
+        cacheServiceRoot(myContext->service, myContext->uri, getPayloadJson(payload));
+    }
+    myContext->callback(success, httpCode, payload, myContext->originalContext);
+    serviceDecRef(myContext->service);
+    free(myContext->uri);
+    free(myContext);
+}
+
+/*Deliver a cached root on the async thread like any other answer*/
+static void deliverCachedServiceRoot(void* context)
+{
+    rootCacheContext* myContext = (rootCacheContext*)context;
+
+    myContext->callback(true, 200, myContext->payload, myContext->originalContext);
+    serviceDecRef(myContext->service);
+    free(myContext);
+}
+
+bool getRedfishServiceRootAsync(redfishService* service, const char* version, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    json_t* versionNode;
+    const char* verUrl;
+    json_t* root;
+    rootCacheContext* myContext;
+    bool ret;
+
+    if(version == NULL)
+    {
+        versionNode = json_object_get(service->versions, "v1");
+    }
+    else
+    {
+        versionNode = json_object_get(service->versions, version);
+    }
+    if(versionNode == NULL)
+    {
+        return false;
+    }
+    verUrl = json_string_value(versionNode);
+    if(verUrl == NULL)
+    {
+        return false;
+    }
+    if(serviceRootCacheable(options) == false)
+    {
+        return getUriFromServiceAsync(service, verUrl, options, callback, context);
+    }
+    myContext = (rootCacheContext*)malloc(sizeof(rootCacheContext));
+    if(myContext == NULL)
+    {
+        return false;
+    }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->service = service;
+    myContext->uri = NULL;
+    myContext->payload = NULL;
+    serviceIncRef(service);
+    root = getCachedServiceRoot(service, verUrl);
+    if(root)
+    {
+        myContext->payload = createRedfishPayload(root, service);
+        ret = queueAsyncWork(service, deliverCachedServiceRoot, myContext);
+        if(ret == false)
+        {
+            cleanupPayload(myContext->payload);
+            serviceDecRef(service);
+            free(myContext);
+        }
+        return ret;
+    }
+    myContext->uri = safeStrdup(verUrl);
+    ret = getUriFromServiceAsync(service, verUrl, options, gotServiceRootForCache, myContext);
+    if(ret == false)
+    {
+        serviceDecRef(service);
+        free(myContext->uri);
+        free(myContext);
+    }
+    return ret;
+}
+
+typedef struct
+{
+    redfishAsyncCallback callback;
+    void* originalContext;
+    redPathPlan* plan;
+    redfishAsyncOptions* options;
+    /** The service the path is evaluated on **/
+    redfishService* service;
+    /** The remembered URI requested in place of the first steps of the path, NULL if the walk starts at the root **/
+    char* memoUri;
+    /** The first step not covered by memoUri **/
+    redPathNode* resume;
+    /** options without the query options, for the requests before the last step **/
+    redfishAsyncOptions hopOptions;
+    /** &hopOptions or NULL if the caller gave no options **/
+    redfishAsyncOptions* hopOptionsPtr;
+} redpathAsyncContext;
+
+/*The query options only apply to the service root if the path ends there*/
+static redfishAsyncOptions* getRedPathRootOptions(redpathAsyncContext* myContext)
+{
+    if(redpathPlanNodes(myContext->plan)->next)
+    {
+        return myContext->hopOptionsPtr;
+    }
+    return myContext->options;
+}
+
+void gotServiceRootAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    redpathAsyncContext* myContext = (redpathAsyncContext*)context;
+    redPathNode* redpath = redpathPlanNodes(myContext->plan);
+    redfishPayload* root = payload;
+    bool ret;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %p, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    if(success == false || httpCode >= 400 || redpath->next == NULL)
+    {
+        myContext->callback(success, httpCode, payload, myContext->originalContext);
+        redpathPlanDecRef(myContext->plan);
+        free(context);
+        return;
+    }
+    recordServiceFeatures(root->service, getPayloadJson(root));
+    ret = getPayloadForPlanAsync(root, myContext->plan, redpath->next, myContext->options, myContext->callback, myContext->originalContext);
+    cleanupPayload(root);
+    if(ret == false)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Failed to get next path section immediately...", __func__);
+        myContext->callback(ret, 0xFFFF, NULL, myContext->originalContext);
+    }
+    redpathPlanDecRef(myContext->plan);
+    free(context);
+}
+
+static void gotMemoResourceAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+{
+    redpathAsyncContext* myContext = (redpathAsyncContext*)context;
+    bool ret;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+
+    if(httpCode == 404)
+    {
+        //The resource has moved, forget it and walk the whole path again
+        REDFISH_DEBUG_INFO_PRINT("%s: %s is gone, following the path from the root\n", __func__, myContext->memoUri);
+        pathMemoForget(myContext->service, myContext->memoUri);
+        cleanupPayload(payload);
+        free(myContext->memoUri);
+        myContext->memoUri = NULL;
+        if(getRedfishServiceRootAsync(myContext->service, redpathPlanNodes(myContext->plan)->version, getRedPathRootOptions(myContext), gotServiceRootAsync, myContext) == false)
+        {
+            myContext->callback(false, 0xFFFF, NULL, myContext->originalContext);
+            redpathPlanDecRef(myContext->plan);
+            free(myContext);
+        }
+        return;
+    }
+    free(myContext->memoUri);
+    if(success == false || httpCode >= 400 || myContext->resume == NULL)
+    {
+        myContext->callback(success, httpCode, payload, myContext->originalContext);
+        redpathPlanDecRef(myContext->plan);
+        free(context);
+        return;
+    }
+    ret = getPayloadForPlanAsync(payload, myContext->plan, myContext->resume, myContext->options, myContext->callback, myContext->originalContext);
+    cleanupPayload(payload);
+    if(ret == false)
+    {
+        myContext->callback(ret, 0xFFFF, NULL, myContext->originalContext);
+    }
+    redpathPlanDecRef(myContext->plan);
+    free(context);
+}
+
+/*Follow the remembered steps from the root as far as they go, returns NULL if not even the first step is known*/
+static char* getMemoUriForPath(redfishService* service, redPathNode* redpath, redPathNode** resume)
+{
+    json_t* versionNode;
+    char* uri;
+    char* next;
+    redPathNode* step;
+
+    versionNode = json_object_get(service->versions, redpath->version ? redpath->version : "v1");
+    uri = safeStrdup(json_string_value(versionNode));
+    if(uri == NULL)
+    {
+        return NULL;
+    }
+    for(step = redpath->next; step; step = step->next)
+    {
+        next = pathMemoLookup(service, uri, step);
+        if(next == NULL)
+        {
+            break;
+        }
+        free(uri);
+        uri = next;
+    }
+    if(step == redpath->next)
+    {
+        free(uri);
+        return NULL;
+    }
+    *resume = step;
+    return uri;
+}
+
+bool getPayloadByPathAsync(redfishService* service, const char* path, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+{
+    redPathPlan* plan;
+    bool ret;
+    redpathAsyncContext* myContext;
+
+    if(!service || !path)
+    {
+        return false;
+    }
+
+    plan = redpathPlanGet(path);
+    if(!plan)
+    {
+        return false;
+    }
+    if(!redpathPlanNodes(plan)->isRoot)
+    {
+        redpathPlanDecRef(plan);
+        return false;
+    }
+    myContext = malloc(sizeof(redpathAsyncContext));
+    if(!myContext)
+    {
+        redpathPlanDecRef(plan);
+        return false;
+    }
+    myContext->callback = callback;
+    myContext->originalContext = context;
+    myContext->plan = plan;
+    myContext->options = options;
+    myContext->service = service;
+    myContext->memoUri = NULL;
+    myContext->resume = NULL;
+    myContext->hopOptionsPtr = odataQueryStripOptions(&myContext->hopOptions, options);
+    if(pathMemoEnabled(service))
+    {
+        myContext->memoUri = getMemoUriForPath(service, redpathPlanNodes(plan), &myContext->resume);
+    }
+    if(myContext->memoUri)
+    {
+        ret = getUriFromServiceAsync(service, myContext->memoUri, myContext->resume ? myContext->hopOptionsPtr : options, gotMemoResourceAsync, myContext);
+        if(ret == false)
+        {
+            free(myContext->memoUri);
+        }
+    }
+    else
+    {
+        ret = getRedfishServiceRootAsync(service, redpathPlanNodes(plan)->version, getRedPathRootOptions(myContext), gotServiceRootAsync, myContext);
+    }
+    if(ret == false)
+    {
+        free(myContext);
+        redpathPlanDecRef(plan);
+    }
+    return ret;
+}
+
+/** One step shared by every path in a batch that starts the same way **/
+struct _pathBatchNode
 {
-    char* url;
-    asyncHttpRequest* request;
-    rawAsyncCallbackContextWrapper* myContext;
-    bool ret;
+    /** The batch this step belongs to **/
+    pathBatch* batch;
+    /** The RedPath node to evaluate, owned by one of the batch's plans **/
+    redPathNode* step;
+    /** The indexes of the paths that end at this step **/
+    size_t* ends;
+    /** The number of entries in ends **/
+    size_t endCount;
+    /** The steps that follow this one **/
+    pathBatchNode** children;
+    /** The number of entries in children **/
+    size_t childCount;
+};
 
-    serviceIncRef(service);
+/** Internal structure used for a batch of RedPath queries **/
+struct _pathBatch
+{
+    /** The service being queried, a reference is held until the batch is done **/
+    redfishService* service;
+    /** The callback for each path **/
+    redfishPathsCallback callback;
+    /** The original context for the callback **/
+    void* originalContext;
+    /** A copy of the caller's options, including its strings **/
+    redfishAsyncOptions options;
+    /** The options to pass on, NULL if the caller gave none **/
+    redfishAsyncOptions* optionsPtr;
+    /** options without the query options, for the steps that are not the last step of any path **/
+    redfishAsyncOptions hopOptions;
+    /** The plan for each path **/
+    redPathPlan** plans;
+    /** The number of paths **/
+    size_t count;
+    /** The service root for each version requested **/
+    pathBatchNode** roots;
+    /** The number of entries in roots **/
+    size_t rootCount;
+    /** One reference for each step in progress and one for the starting call **/
+    size_t refCount;
+    /** The number of paths that could not be obtained **/
+    size_t failed;
+};
 
-    url = makeUrlForService(service, uri);
-    if(!url)
+bool getPayloadsByPathsAsync(redfishService* service, const char** paths, size_t count, redfishAsyncOptions* options, redfishPathsCallback callback, void* context)
+{
+    pathBatch* batch;
+    pathBatchNode* node;
+    redPathNode* step;
+    size_t* tmp;
+    size_t i;
+
+    if(!service || (!paths && count) || !callback)
     {
-        REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not make url for uri %s\n", __func__, uri);
-        serviceDecRef(service);
         return false;
     }
-
-    request = createRequest(url, HTTP_DELETE, 0, NULL);
-    free(url);
-    if(request == NULL)
+    batch = (pathBatch*)calloc(1, sizeof(pathBatch));
+    if(!batch)
     {
-        REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not allocate request structure\n", __func__);
-        serviceDecRef(service);
         return false;
     }
-    setupRequestFromOptions(request, service, options);
-
-    myContext = malloc(sizeof(rawAsyncCallbackContextWrapper));
-    if(myContext == NULL)
+    batch->callback = callback;
+    batch->originalContext = context;
+    batch->count = count;
+    batch->plans = (redPathPlan**)calloc(count + 1, sizeof(redPathPlan*));
+    if(!batch->plans)
     {
-        REDFISH_DEBUG_ERR_PRINT("%s: Error. Could not allocate context.\n", __func__);
-        freeAsyncRequest(request);
-        serviceDecRef(service);
+        free(batch);
         return false;
     }
-    myContext->callback = callback;
-    myContext->originalContext = context;
-    myContext->originalOptions = options;
-    myContext->service = service;
-    ret = startRawAsyncRequest(service, request, rawCallbackWrapper, myContext);
-    if(ret == false)
+    if(options)
     {
-        free(myContext);
+        if(odataQueryCopyOptions(&batch->options, options) == false)
+        {
+            free(batch->plans);
+            free(batch);
+            return false;
+        }
+        batch->optionsPtr = &batch->options;
+        odataQueryStripOptions(&batch->hopOptions, &batch->options);
     }
-    return ret;
+    //Merge the paths into a tree so each shared prefix is only requested once
+    for(i = 0; i < count; i++)
+    {
+        batch->plans[i] = redpathPlanGet(paths[i]);
+        if(!batch->plans[i] || !redpathPlanNodes(batch->plans[i])->isRoot)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Unable to use redpath %s\n", __func__, paths[i]);
+            pathBatchFree(batch);
+            return false;
+        }
+        step = redpathPlanNodes(batch->plans[i]);
+        node = pathBatchAddStep(batch, &batch->roots, &batch->rootCount, step);
+        for(step = step->next; step && node; step = step->next)
+        {
+            node = pathBatchAddStep(batch, &node->children, &node->childCount, step);
+        }
+        tmp = node ? (size_t*)realloc(node->ends, (node->endCount + 1) * sizeof(size_t)) : NULL;
+        if(!tmp)
+        {
+            pathBatchFree(batch);
+            return false;
+        }
+        node->ends = tmp;
+        node->ends[node->endCount++] = i;
+    }
+    batch->service = service;
+    serviceIncRef(service);
+    batch->refCount = 1 + batch->rootCount;
+    for(i = 0; i < batch->rootCount; i++)
+    {
+        node = batch->roots[i];
+        if(getRedfishServiceRootAsync(service, node->step->version, pathBatchOptions(node), gotPathBatchPayload, node) == false)
+        {
+            if(i == 0)
+            {
+                //Nothing was started, so the caller hears about it from the return value alone
+                pathBatchFree(batch);
+                serviceDecRef(service);
+                return false;
+            }
+            //Other roots are in progress, report this one from the async thread like any other failure
+            if(queueAsyncWork(service, pathBatchStartFailed, node) == false)
+            {
+                pathBatchFail(node, false, 0xFFFF, NULL);
+                pathBatchDecRef(batch);
+            }
+        }
+    }
+    //The starting reference is dropped on the async thread too, so the final call never happens before this returns
+    if(queueAsyncWork(service, pathBatchRelease, batch) == false)
+    {
+        pathBatchDecRef(batch);
+    }
+    return true;
 }
 
-bool getRedfishServiceRootAsync(redfishService* service, const char* version, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+/*Report a service root that could not be requested, run on the async thread*/
+static void pathBatchStartFailed(void* context)
 {
-    json_t* versionNode;
-    const char* verUrl;
-    bool ret;
+    pathBatchNode* node = (pathBatchNode*)context;
+    pathBatch* batch = node->batch;
 
-    if(version == NULL)
+    pathBatchFail(node, false, 0xFFFF, NULL);
+    pathBatchDecRef(batch);
+}
+
+/*Drop the reference getPayloadsByPathsAsync() started the batch with, run on the async thread*/
+static void pathBatchRelease(void* context)
+{
+    pathBatchDecRef((pathBatch*)context);
+}
+
+static pathBatchNode* pathBatchAddStep(pathBatch* batch, pathBatchNode*** list, size_t* listCount, redPathNode* step)
+{
+    pathBatchNode** tmp;
+    pathBatchNode* node;
+    size_t i;
+    bool separate;
+
+    //With query options the last step of a path is read with them and any other step without, so the two can't be shared
+    separate = (odataQueryRequested(batch->optionsPtr) != 0 || batch->options.maxMembers != 0);
+    for(i = 0; i < *listCount; i++)
     {
-        versionNode = json_object_get(service->versions, "v1");
+        if(pathBatchStepEqual((*list)[i]->step, step) && (separate == false || ((*list)[i]->step->next == NULL) == (step->next == NULL)))
+        {
+            return (*list)[i];
+        }
     }
-    else
+    tmp = (pathBatchNode**)realloc(*list, (*listCount + 1) * sizeof(pathBatchNode*));
+    if(!tmp)
     {
-        versionNode = json_object_get(service->versions, version);
+        return NULL;
     }
-    if(versionNode == NULL)
+    *list = tmp;
+    node = (pathBatchNode*)calloc(1, sizeof(pathBatchNode));
+    if(!node)
     {
-        return false;
+        return NULL;
     }
-    verUrl = json_string_value(versionNode);
-    if(verUrl == NULL)
+    node->batch = batch;
+    node->step = step;
+    (*list)[(*listCount)++] = node;
+    return node;
+}
+
+static bool pathBatchStepEqual(redPathNode* a, redPathNode* b)
+{
+    if(a->isRoot || b->isRoot)
     {
-        return false;
+        return (a->isRoot == b->isRoot && pathBatchStringEqual(a->version, b->version));
     }
-    ret = getUriFromServiceAsync(service, verUrl, options, callback, context);
-    return ret;
+    if(a->isIndex || b->isIndex)
+    {
+        return (a->isIndex == b->isIndex && a->index == b->index);
+    }
+    if(a->nodeName || b->nodeName)
+    {
+        return pathBatchStringEqual(a->nodeName, b->nodeName);
+    }
+    return (a->op == b->op && pathBatchStringEqual(a->propName, b->propName) && pathBatchStringEqual(a->value, b->value));
 }
 
-typedef struct
+static bool pathBatchStringEqual(const char* a, const char* b)
 {
-    redfishAsyncCallback callback;
-    void* originalContext;
-    redPathNode* redpath;
-    redfishAsyncOptions* options;
-} redpathAsyncContext;
+    if(a == NULL || b == NULL)
+    {
+        return (a == b);
+    }
+    return (strcmp(a, b) == 0);
+}
 
-void gotServiceRootAsync(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
+static void gotPathBatchPayload(bool success, unsigned short httpCode, redfishPayload* payload, void* context)
 {
-    redpathAsyncContext* myContext = (redpathAsyncContext*)context;
-    redfishPayload* root = payload;
-    bool ret;
+    pathBatchNode* node = (pathBatchNode*)context;
+    pathBatch* batch = node->batch;
+    pathBatchNode* child;
+    size_t i;
 
-    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %p, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. success = %u, httpCode = %u, payload = %p, context = %p\n", __func__, success, httpCode, payload, context);
 
-    if(success == false || httpCode >= 400 || myContext->redpath->next == NULL)
+    if(success == false || httpCode >= 400)
     {
-        myContext->callback(success, httpCode, payload, myContext->originalContext);
-        cleanupRedPath(myContext->redpath);
-        free(context);
+        pathBatchFail(node, success, httpCode, payload);
+        cleanupPayload(payload);
+        pathBatchDecRef(batch);
         return;
     }
-    ret = getPayloadForPathAsync(root, myContext->redpath->next, myContext->options, myContext->callback, myContext->originalContext);
-    cleanupPayload(root);
-    if(ret == false)
+    if(node->step->isRoot && node->childCount && payload)
     {
-        REDFISH_DEBUG_ERR_PRINT("%s: Failed to get next path section immediately...", __func__);
-        myContext->callback(ret, 0xFFFF, NULL, myContext->originalContext);
-        cleanupRedPath(myContext->redpath);
+        recordServiceFeatures(batch->service, getPayloadJson(payload));
     }
-    else
+    for(i = 0; i < node->endCount; i++)
     {
-        //Free just this redpath node...
-        myContext->redpath->next = NULL;
-        cleanupRedPath(myContext->redpath);
+        batch->callback(success, httpCode, copyRedfishPayload(payload), node->ends[i], batch->originalContext);
     }
-    free(context);
+    for(i = 0; i < node->childCount; i++)
+    {
+        child = node->children[i];
+#ifdef _MSC_VER
+#if _M_AMD64
+        InterlockedIncrement64(&(batch->refCount));
+#else
+        InterlockedIncrement(&(batch->refCount));
+#endif
+#else
+        __sync_fetch_and_add(&(batch->refCount), 1);
+#endif
+        if(getPayloadForNodeAsync(payload, child->step, pathBatchOptions(child), gotPathBatchPayload, child) == false)
+        {
+            pathBatchFail(child, false, 0xFFFF, NULL);
+            pathBatchDecRef(batch);
+        }
+    }
+    cleanupPayload(payload);
+    pathBatchDecRef(batch);
 }
 
-bool getPayloadByPathAsync(redfishService* service, const char* path, redfishAsyncOptions* options, redfishAsyncCallback callback, void* context)
+/*Report the failure of a step to every path that goes through it*/
+static void pathBatchFail(pathBatchNode* node, bool success, unsigned short httpCode, redfishPayload* payload)
 {
-    redPathNode* redpath;
-    bool ret;
-    redpathAsyncContext* myContext;
+    pathBatch* batch = node->batch;
+    size_t i;
 
-    if(!service || !path)
+    for(i = 0; i < node->endCount; i++)
     {
-        return false;
+#ifdef _MSC_VER
+#if _M_AMD64
+        InterlockedIncrement64(&(batch->failed));
+#else
+        InterlockedIncrement(&(batch->failed));
+#endif
+#else
+        __sync_fetch_and_add(&(batch->failed), 1);
+#endif
+        batch->callback(success, httpCode, copyRedfishPayload(payload), node->ends[i], batch->originalContext);
+    }
+    for(i = 0; i < node->childCount; i++)
+    {
+        pathBatchFail(node->children[i], success, httpCode, payload);
     }
+}
 
-    redpath = parseRedPath(path);
-    if(!redpath)
+static void pathBatchDecRef(pathBatch* batch)
+{
+    size_t newCount;
+    redfishService* service;
+    redfishPathsCallback callback;
+    void* originalContext;
+    bool success;
+
+#ifdef _MSC_VER
+#if _M_AMD64
+    newCount = InterlockedDecrement64(&(batch->refCount));
+#else
+    newCount = InterlockedDecrement(&(batch->refCount));
+#endif
+#else
+    newCount = __sync_sub_and_fetch(&(batch->refCount), 1);
+#endif
+    if(newCount != 0)
     {
-        return false;
+        return;
     }
-    if(!redpath->isRoot)
+    service = batch->service;
+    callback = batch->callback;
+    originalContext = batch->originalContext;
+    success = (batch->failed == 0);
+    pathBatchFree(batch);
+    serviceDecRef(service);
+    callback(success, 200, NULL, REDFISH_PATHS_END, originalContext);
+}
+
+static void pathBatchFree(pathBatch* batch)
+{
+    size_t i;
+
+    pathBatchFreeNodes(batch->roots, batch->rootCount);
+    for(i = 0; i < batch->count; i++)
     {
-        cleanupRedPath(redpath);
-        return false;
+        redpathPlanDecRef(batch->plans[i]);
     }
-    myContext = malloc(sizeof(redpathAsyncContext));
-    if(!myContext)
+    free(batch->plans);
+    odataQueryFreeOptions(&batch->options);
+    free(batch);
+}
+
+/*The options to read a step with, only the last step of a path gets the caller's query options*/
+static redfishAsyncOptions* pathBatchOptions(pathBatchNode* node)
+{
+    if(node->childCount && node->batch->optionsPtr)
     {
-        cleanupRedPath(redpath);
-        return false;
+        return &node->batch->hopOptions;
     }
-    myContext->callback = callback;
-    myContext->originalContext = context;
-    myContext->redpath = redpath;
-    myContext->options = options;
-    ret = getRedfishServiceRootAsync(service, redpath->version, options, gotServiceRootAsync, myContext);
-    if(ret == false)
+    return node->batch->optionsPtr;
+}
+
+static void pathBatchFreeNodes(pathBatchNode** list, size_t listCount)
+{
+    size_t i;
+
+    for(i = 0; i < listCount; i++)
     {
-        free(myContext);
-        cleanupRedPath(redpath);
+        pathBatchFreeNodes(list[i]->children, list[i]->childCount);
+        free(list[i]->ends);
+        free(list[i]);
     }
-    return ret;
+    free(list);
 }
 
 bool registerForEvents(redfishService* service, const char* postbackUri, unsigned int eventTypes, redfishEventCallback callback, const char* context)
@@ -1076,16 +2085,24 @@ redfishPayload* getRedfishServiceRoot(redfishService* service, const char* versi
     {
         return NULL;
     }
+    value = getCachedServiceRoot(service, verUrl);
+    if(value)
+    {
+        return createRedfishPayload(value, service);
+    }
     value = getUriFromService(service, verUrl);
     if(value == NULL)
     {
         return NULL;
     }
+    recordServiceFeatures(service, value);
+    cacheServiceRoot(service, verUrl, value);
     return createRedfishPayload(value, service);
 }
 
 redfishPayload* getPayloadByPath(redfishService* service, const char* path)
 {
+    redPathPlan* plan;
     redPathNode* redpath;
     redfishPayload* root;
     redfishPayload* ret;
@@ -1095,25 +2112,26 @@ redfishPayload* getPayloadByPath(redfishService* service, const char* path)
         return NULL;
     }
 
-    redpath = parseRedPath(path);
-    if(!redpath)
+    plan = redpathPlanGet(path);
+    if(!plan)
     {
         return NULL;
     }
+    redpath = redpathPlanNodes(plan);
     if(!redpath->isRoot)
     {
-        cleanupRedPath(redpath);
+        redpathPlanDecRef(plan);
         return NULL;
     }
     root = getRedfishServiceRoot(service, redpath->version);
     if(redpath->next == NULL)
     {
-        cleanupRedPath(redpath);
+        redpathPlanDecRef(plan);
         return root;
     }
     ret = getPayloadForPath(root, redpath->next);
     cleanupPayload(root);
-    cleanupRedPath(redpath);
+    redpathPlanDecRef(plan);
     return ret;
 }
 
@@ -1181,10 +2199,26 @@ static void freeServicePtr(redfishService* service)
         terminateAsyncEventThread(service);
     }
     terminateAsyncThread(service);
+    if(service->replay && service->selfTerm == false)
+    {
+        //Otherwise the async thread still answers whatever is queued ahead of its termination and releases it on exit
+        cleanupSnapshot(service->replay);
+        service->replay = NULL;
+    }
     free(service->host);
     service->host = NULL;
     json_decref(service->versions);
     service->versions = NULL;
+    //The locks live until the service memory is freed, here or by the thread that frees it, so a request still being answered finds the caches off
+    mutex_lock(&service->pathMemoLock);
+    service->pathMemoLifetime = 0;
+    json_decref(service->pathMemo);
+    service->pathMemo = NULL;
+    mutex_unlock(&service->pathMemoLock);
+    mutex_lock(&service->rootCacheLock);
+    json_decref(service->rootCache);
+    service->rootCache = NULL;
+    mutex_unlock(&service->rootCacheLock);
     if(service->sessionToken != NULL)
     {
         free(service->sessionToken);
@@ -1202,6 +2236,8 @@ static void freeServicePtr(redfishService* service)
     }
     if(service->selfTerm == false && service->eventTerm == false)
     {
+        mutex_destroy(&service->pathMemoLock);
+        mutex_destroy(&service->rootCacheLock);
         free(service);
     }
 }
@@ -1288,6 +2324,8 @@ static redfishService* createServiceEnumeratorNoAuth(const char* host, const cha
 #endif
     ret->flags = flags;
     ret->tcpSocket = -1;
+    mutex_init(&ret->pathMemoLock);
+    mutex_init(&ret->rootCacheLock);
     if(enumerate)
     {
         ret->versions = getVersions(ret, rootUri);
@@ -1296,6 +2334,32 @@ static redfishService* createServiceEnumeratorNoAuth(const char* host, const cha
     return ret;
 }
 
+redfishService* createServiceFromSnapshot(redfishSnapshot* snapshot, unsigned long latency, unsigned int flags)
+{
+    redfishService* ret;
+
+    REDFISH_DEBUG_DEBUG_PRINT("%s: Entered. snapshot = %p, latency = %lu, flags = %x\n", __func__, snapshot, latency, flags);
+    if(snapshot == NULL)
+    {
+        return NULL;
+    }
+    ret = createServiceEnumeratorNoAuth(REDFISH_REPLAY_HOST, NULL, false, flags);
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    ret->replay = snapshotIncRef(snapshot);
+    ret->replayLatency = latency;
+    ret->versions = getVersions(ret, NULL);
+    if(ret->versions == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to read the version document from the snapshot\n", __func__);
+        serviceDecRef(ret);
+        return NULL;
+    }
+    return ret;
+}
+
 static bool createServiceEnumeratorNoAuthAsync(const char* host, const char* rootUri, unsigned int flags, redfishCreateAsyncCallback callback, void* context)
 {
     redfishService* ret;
@@ -1314,6 +2378,8 @@ static bool createServiceEnumeratorNoAuthAsync(const char* host, const char* roo
 #endif
     ret->flags = flags;
     ret->tcpSocket = -1;
+    mutex_init(&ret->pathMemoLock);
+    mutex_init(&ret->rootCacheLock);
     rc = getVersionsAsync(ret, rootUri, callback, context);
     if(rc == false)
     {
@@ -1408,7 +2474,7 @@ static redfishService* createServiceEnumeratorSessionAuth(const char* host, cons
         cleanupServiceEnumerator(ret);
         return NULL;
     }
-    session = json_object_get(links->json, "Sessions");
+    session = json_object_get(getPayloadJson(links), "Sessions");
     if(session == NULL)
     {
         cleanupPayload(links);
@@ -1581,7 +2647,7 @@ static void gotServiceRootServiceAuth(bool success, unsigned short httpCode, red
         free(myContext);
         return;
     }
-    session = json_object_get(links->json, "Sessions");
+    session = json_object_get(getPayloadJson(links), "Sessions");
     if(session == NULL)
     {
         cleanupPayload(links);
@@ -1753,6 +2819,57 @@ static char* makeUrlForService(redfishService* service, const char* uri)
     return url;
 }
 
+static void recordServiceFeatures(redfishService* service, json_t* root)
+{
+    if(service == NULL || (service->protocolFeatures & SERVICE_FEATURES_KNOWN))
+    {
+        return;
+    }
+    if(service->replay)
+    {
+        //The snapshot only holds whole resources, so every query option is applied locally
+        service->protocolFeatures = SERVICE_FEATURES_KNOWN;
+        return;
+    }
+    service->protocolFeatures = SERVICE_FEATURES_KNOWN | odataQueryFeaturesFromServiceRoot(root);
+}
+
+static char* makeQueryUrlForService(redfishService* service, const char* uri, redfishAsyncOptions* options, unsigned int* local)
+{
+    char* url;
+    char* query;
+    char* tmp;
+    size_t urlLength;
+    size_t queryLength;
+    unsigned int send;
+
+    url = makeUrlForService(service, uri);
+    odataQuerySplit(service->protocolFeatures, options, &send, local);
+    if(url == NULL || send == 0)
+    {
+        return url;
+    }
+    query = odataQueryString(uri, options, send);
+    if(query == NULL)
+    {
+        free(url);
+        return NULL;
+    }
+    urlLength = strlen(url);
+    queryLength = strlen(query);
+    tmp = (char*)realloc(url, urlLength + queryLength + 1);
+    if(tmp == NULL)
+    {
+        free(url);
+        free(query);
+        return NULL;
+    }
+    url = tmp;
+    memcpy(url + urlLength, query, queryLength + 1);
+    free(query);
+    return url;
+}
+
 static json_t* getVersions(redfishService* service, const char* rootUri)
 {
     json_t* data;
@@ -1844,7 +2961,7 @@ static void gotVersions(bool success, unsigned short httpCode, redfishPayload* p
         return;
     }
 
-    myContext->service->versions = payload->json;
+    myContext->service->versions = getPayloadJson(payload);
     //Get rid of the payload's service reference...
     serviceDecRef(myContext->service);
     free(payload);
@@ -1951,7 +3068,7 @@ static char* getEventSubscriptionUri(redfishService* service)
     {
         return NULL;
     }
-    odataId = json_object_get(eventSub->json, "@odata.id");
+    odataId = json_object_get(getPayloadJson(eventSub), "@odata.id");
     if(odataId == NULL)
     {
         cleanupPayload(eventSub);
@@ -1971,8 +3088,13 @@ static void addStringToJsonObject(json_t* object, const char* key, const char* v
     json_decref(jValue);
 }
 
-static redfishPayload* getPayloadFromAsyncResponse(asyncHttpResponse* response, redfishService* service)
+#ifdef _MSC_VER
+#define strncasecmp _strnicmp
+#endif
+
+static redfishPayload* getPayloadFromAsyncResponse(asyncHttpResponse* response, redfishService* service, redfishAsyncOptions* options)
 {
+    redfishPayload* ret;
     httpHeader* header;
     size_t length = 0;
     char* type = NULL;
@@ -1992,6 +3114,27 @@ static redfishPayload* getPayloadFromAsyncResponse(asyncHttpResponse* response,
     {
         type = header->value;
     }
+    if(type == NULL || strncasecmp(type, "application/json", 16) == 0)
+    {
+        //Take the body from the response instead of copying it, the payload will parse it now or when anyone asks
+        ret = createDeferredRedfishPayload(response->body, response->bodySize, service);
+        response->body = NULL;
+        response->bodySize = 0;
+        if(ret == NULL)
+        {
+            return NULL;
+        }
+        if(options->flags & REDFISH_ASYNC_FLAG_ARENA)
+        {
+            ret->arena = arenaCreate();
+        }
+        if(options->bodyHandling != REDFISH_BODY_LAZY && getPayloadJson(ret) == NULL)
+        {
+            cleanupPayload(ret);
+            return NULL;
+        }
+        return ret;
+    }
     return createRedfishPayloadFromContent(response->body, length, type, service);
 }
 
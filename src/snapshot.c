@@ -0,0 +1,719 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "internal_service.h"
+#include "internal_snapshot.h"
+#include "internal_payload.h"
+#include "tape.h"
+#include "debug.h"
+#include "util.h"
+
+/** The first bytes of every snapshot file **/
+#define SNAPSHOT_MAGIC   "RFSS"
+/** The current snapshot layout version **/
+#define SNAPSHOT_VERSION 4
+/** Tapes start on this boundary in the file **/
+#define SNAPSHOT_ALIGN   8
+
+/** The header at the start of the file **/
+typedef struct
+{
+    /** SNAPSHOT_MAGIC **/
+    char magic[4];
+    /** SNAPSHOT_VERSION **/
+    uint32_t version;
+    /** The number of resources **/
+    uint64_t count;
+    /** The offset of the index, count snapshotIndexEntry structures sorted by URI **/
+    uint64_t index;
+    /** The size of the file in bytes **/
+    uint64_t size;
+} snapshotHeader;
+
+/** An entry in the index **/
+typedef struct
+{
+    /** The offset of the NUL terminated URI **/
+    uint64_t uri;
+    /** The offset of the resource's tape **/
+    uint64_t tape;
+    /** The tapeHash() of the resource **/
+    uint64_t hash;
+    /** The responseTime of the payload the resource was written from **/
+    uint64_t responseTime;
+    /** The length of the URI **/
+    uint32_t uriLength;
+    /** The size of the resource's tape **/
+    uint32_t tapeSize;
+} snapshotIndexEntry;
+
+/** A resource written so far **/
+typedef struct
+{
+    /** The URI of the resource **/
+    char* uri;
+    /** The offset of the resource's tape **/
+    uint64_t tape;
+    /** The tapeHash() of the resource **/
+    uint64_t hash;
+    /** The responseTime of the payload the resource was written from **/
+    uint64_t responseTime;
+    /** The size of the resource's tape **/
+    uint32_t tapeSize;
+} snapshotWriterEntry;
+
+struct _redfishSnapshotWriter
+{
+    /** The file being written **/
+    FILE* file;
+    /** The destination file name **/
+    char* fileName;
+    /** The name of the file being written **/
+    char* tempName;
+    /** The resources written so far **/
+    snapshotWriterEntry* entries;
+    /** The number of entries used **/
+    size_t count;
+    /** The number of entries allocated **/
+    size_t size;
+    /** Maps each URI to its position in entries **/
+    json_t* uris;
+    /** The current offset in the file **/
+    uint64_t offset;
+    /** Set if anything could not be written **/
+    bool failed;
+};
+
+struct _redfishSnapshot
+{
+    /** The number of users of the mapping, the snapshot itself and each tape read from it **/
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 refCount;
+#else
+    LONG refCount;
+#endif
+#else
+    size_t refCount;
+#endif
+    /** The mapped file **/
+    const unsigned char* data;
+    /** The size of the mapped file **/
+    size_t size;
+    /** The index in the mapped file **/
+    const snapshotIndexEntry* index;
+    /** The number of resources **/
+    size_t count;
+    /** The service for payloads read from the snapshot **/
+    redfishService* service;
+#ifdef _MSC_VER
+    /** The file mapping object **/
+    HANDLE mapping;
+#endif
+};
+
+static bool writeBytes(redfishSnapshotWriter* writer, const void* data, size_t length);
+static bool writePadding(redfishSnapshotWriter* writer);
+static int compareWriterEntries(const void* a, const void* b);
+static void freeSnapshotWriter(redfishSnapshotWriter* writer);
+static bool mapSnapshotFile(const char* fileName, redfishSnapshot* snapshot);
+static void snapshotDecRef(void* context);
+static payloadTape* getEntryTape(redfishSnapshot* snapshot, const snapshotIndexEntry* entry);
+static const snapshotIndexEntry* findSnapshotEntry(redfishSnapshot* snapshot, const char* uri);
+static redfishPayload* getEntryPayload(redfishSnapshot* snapshot, const snapshotIndexEntry* entry, redfishService* service);
+static const snapshotIndexEntry* findReplayEntry(redfishService* service, const char** uri);
+static bool validateSnapshotIndex(const unsigned char* data, const snapshotHeader* header);
+
+redfishSnapshotWriter* createSnapshotWriter(const char* fileName)
+{
+    redfishSnapshotWriter* writer;
+    snapshotHeader header;
+
+    if(fileName == NULL)
+    {
+        return NULL;
+    }
+    writer = (redfishSnapshotWriter*)calloc(1, sizeof(redfishSnapshotWriter));
+    if(writer == NULL)
+    {
+        return NULL;
+    }
+    writer->fileName = safeStrdup(fileName);
+    writer->tempName = (char*)malloc(strlen(fileName) + 5);
+    writer->uris = json_object();
+    if(writer->fileName == NULL || writer->tempName == NULL || writer->uris == NULL)
+    {
+        freeSnapshotWriter(writer);
+        return NULL;
+    }
+    sprintf(writer->tempName, "%s.tmp", fileName);
+    writer->file = fopen(writer->tempName, "wb");
+    if(writer->file == NULL)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to create %s\n", __func__, writer->tempName);
+        freeSnapshotWriter(writer);
+        return NULL;
+    }
+    //The real header is written once the index is
+    memset(&header, 0, sizeof(header));
+    writeBytes(writer, &header, sizeof(header));
+    return writer;
+}
+
+bool addSnapshotPayload(redfishSnapshotWriter* writer, const char* uri, redfishPayload* payload)
+{
+    payloadTape* tape;
+    snapshotWriterEntry* tmp;
+    json_t* json;
+    json_t* position;
+    const void* data;
+    size_t size;
+    size_t entry;
+
+    if(writer == NULL || uri == NULL || payload == NULL || payload->contentType != PAYLOAD_CONTENT_JSON)
+    {
+        return false;
+    }
+    if(payload->json == NULL && payload->tape != NULL && payload->tapeNode == tapeRoot(payload->tape))
+    {
+        //Already frozen, write the tape as is
+        tape = tapeIncRef(payload->tape);
+    }
+    else
+    {
+        if(payload->json == NULL && payload->tape != NULL)
+        {
+            //Don't thaw the payload, other threads may be reading the tape
+            json = tapeToJson(payload->tape, payload->tapeNode);
+        }
+        else
+        {
+            json = json_incref(getPayloadJson(payload));
+        }
+        tape = tapeCreateFromJson(json);
+        json_decref(json);
+    }
+    if(tape == NULL)
+    {
+        return false;
+    }
+    position = json_object_get(writer->uris, uri);
+    if(position)
+    {
+        entry = (size_t)json_integer_value(position);
+    }
+    else
+    {
+        if(writer->count == writer->size)
+        {
+            tmp = (snapshotWriterEntry*)realloc(writer->entries, (writer->size ? writer->size * 2 : 256) * sizeof(snapshotWriterEntry));
+            if(tmp == NULL)
+            {
+                tapeDecRef(tape);
+                return false;
+            }
+            writer->entries = tmp;
+            writer->size = writer->size ? writer->size * 2 : 256;
+        }
+        entry = writer->count;
+        writer->entries[entry].uri = safeStrdup(uri);
+        if(writer->entries[entry].uri == NULL)
+        {
+            tapeDecRef(tape);
+            return false;
+        }
+        json_object_set_new(writer->uris, uri, json_integer((json_int_t)entry));
+        writer->count++;
+    }
+    data = tapeData(tape, &size);
+    writePadding(writer);
+    writer->entries[entry].tape = writer->offset;
+    writer->entries[entry].tapeSize = (uint32_t)size;
+    writer->entries[entry].hash = tapeHash(tape, tapeRoot(tape), NULL);
+    writer->entries[entry].responseTime = payload->responseTime;
+    writeBytes(writer, data, size);
+    tapeDecRef(tape);
+    return !writer->failed;
+}
+
+bool closeSnapshotWriter(redfishSnapshotWriter* writer)
+{
+    snapshotHeader header;
+    snapshotIndexEntry entry;
+    uint64_t uriOffset;
+    size_t i;
+    bool ret;
+
+    if(writer == NULL)
+    {
+        return false;
+    }
+    qsort(writer->entries, writer->count, sizeof(snapshotWriterEntry), compareWriterEntries);
+    writePadding(writer);
+    memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.count = writer->count;
+    header.index = writer->offset;
+    //The URIs follow the index
+    uriOffset = writer->offset + (writer->count * sizeof(snapshotIndexEntry));
+    for(i = 0; i < writer->count; i++)
+    {
+        entry.uri = uriOffset;
+        entry.tape = writer->entries[i].tape;
+        entry.hash = writer->entries[i].hash;
+        entry.responseTime = writer->entries[i].responseTime;
+        entry.uriLength = (uint32_t)strlen(writer->entries[i].uri);
+        entry.tapeSize = writer->entries[i].tapeSize;
+        writeBytes(writer, &entry, sizeof(entry));
+        uriOffset += entry.uriLength + 1;
+    }
+    for(i = 0; i < writer->count; i++)
+    {
+        writeBytes(writer, writer->entries[i].uri, strlen(writer->entries[i].uri) + 1);
+    }
+    header.size = writer->offset;
+    if(writer->failed == false && (fseek(writer->file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, writer->file) != 1))
+    {
+        writer->failed = true;
+    }
+    if(fclose(writer->file) != 0)
+    {
+        writer->failed = true;
+    }
+    writer->file = NULL;
+#ifdef _MSC_VER
+    ret = (writer->failed == false && MoveFileExA(writer->tempName, writer->fileName, MOVEFILE_REPLACE_EXISTING));
+#else
+    ret = (writer->failed == false && rename(writer->tempName, writer->fileName) == 0);
+#endif
+    if(ret == false)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to write snapshot %s\n", __func__, writer->fileName);
+        remove(writer->tempName);
+    }
+    freeSnapshotWriter(writer);
+    return ret;
+}
+
+redfishSnapshot* openSnapshot(const char* fileName, redfishService* service)
+{
+    redfishSnapshot* snapshot;
+    snapshotHeader header;
+
+    if(fileName == NULL)
+    {
+        return NULL;
+    }
+    snapshot = (redfishSnapshot*)calloc(1, sizeof(redfishSnapshot));
+    if(snapshot == NULL)
+    {
+        return NULL;
+    }
+    if(mapSnapshotFile(fileName, snapshot) == false)
+    {
+        free(snapshot);
+        return NULL;
+    }
+    snapshot->refCount = 1;
+    if(snapshot->size >= sizeof(header))
+    {
+        memcpy(&header, snapshot->data, sizeof(header));
+    }
+    if(snapshot->size < sizeof(header) || memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.version != SNAPSHOT_VERSION ||
+       header.size > snapshot->size || header.index > header.size || header.count > (header.size - header.index) / sizeof(snapshotIndexEntry) ||
+       (header.index % SNAPSHOT_ALIGN) != 0 || validateSnapshotIndex(snapshot->data, &header) == false)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: %s is not a snapshot\n", __func__, fileName);
+        snapshotDecRef(snapshot);
+        return NULL;
+    }
+    snapshot->index = (const snapshotIndexEntry*)(snapshot->data + header.index);
+    snapshot->count = (size_t)header.count;
+    snapshot->service = service;
+    if(service)
+    {
+        serviceIncRef(service);
+    }
+    return snapshot;
+}
+
+redfishPayload* getSnapshotPayload(redfishSnapshot* snapshot, const char* uri)
+{
+    if(snapshot == NULL)
+    {
+        return NULL;
+    }
+    return getEntryPayload(snapshot, findSnapshotEntry(snapshot, uri), snapshot->service);
+}
+
+redfishPayload* replaySnapshotUri(redfishService* service, const char* uri)
+{
+    const snapshotIndexEntry* entry;
+
+    entry = findReplayEntry(service, &uri);
+    if(entry)
+    {
+        return getEntryPayload(service->replay, entry, service);
+    }
+    if(strcmp(uri, "/redfish") == 0 || strcmp(uri, "/redfish/") == 0)
+    {
+        //Snapshots start at the service root, so answer the version document the service would have
+        return createRedfishPayload(json_pack("{s:s}", "v1", "/redfish/v1/"), service);
+    }
+    return NULL;
+}
+
+unsigned long replaySnapshotDelay(redfishService* service, const char* uri)
+{
+    const snapshotIndexEntry* entry;
+
+    if(service->replayLatency != REDFISH_REPLAY_RECORDED_LATENCY)
+    {
+        return service->replayLatency;
+    }
+    entry = findReplayEntry(service, &uri);
+    return entry ? (unsigned long)entry->responseTime : 0;
+}
+
+size_t getSnapshotCount(redfishSnapshot* snapshot)
+{
+    if(snapshot == NULL)
+    {
+        return 0;
+    }
+    return snapshot->count;
+}
+
+const char* getSnapshotUri(redfishSnapshot* snapshot, size_t index)
+{
+    if(snapshot == NULL || index >= snapshot->count)
+    {
+        return NULL;
+    }
+    return (const char*)(snapshot->data + snapshot->index[index].uri);
+}
+
+payloadTape* getSnapshotTape(redfishSnapshot* snapshot, size_t index)
+{
+    if(snapshot == NULL || index >= snapshot->count)
+    {
+        return NULL;
+    }
+    return getEntryTape(snapshot, &snapshot->index[index]);
+}
+
+uint64_t getSnapshotHash(redfishSnapshot* snapshot, size_t index)
+{
+    if(snapshot == NULL || index >= snapshot->count)
+    {
+        return 0;
+    }
+    return snapshot->index[index].hash;
+}
+
+void cleanupSnapshot(redfishSnapshot* snapshot)
+{
+    if(snapshot == NULL)
+    {
+        return;
+    }
+    snapshotDecRef(snapshot);
+}
+
+static bool writeBytes(redfishSnapshotWriter* writer, const void* data, size_t length)
+{
+    if(writer->failed || (length && fwrite(data, length, 1, writer->file) != 1))
+    {
+        writer->failed = true;
+        return false;
+    }
+    writer->offset += length;
+    return true;
+}
+
+static bool writePadding(redfishSnapshotWriter* writer)
+{
+    static const char zeros[SNAPSHOT_ALIGN] = {0};
+
+    return writeBytes(writer, zeros, (size_t)((SNAPSHOT_ALIGN - (writer->offset % SNAPSHOT_ALIGN)) % SNAPSHOT_ALIGN));
+}
+
+static int compareWriterEntries(const void* a, const void* b)
+{
+    return strcmp(((const snapshotWriterEntry*)a)->uri, ((const snapshotWriterEntry*)b)->uri);
+}
+
+static void freeSnapshotWriter(redfishSnapshotWriter* writer)
+{
+    size_t i;
+
+    if(writer->file)
+    {
+        fclose(writer->file);
+        remove(writer->tempName);
+    }
+    for(i = 0; i < writer->count; i++)
+    {
+        free(writer->entries[i].uri);
+    }
+    free(writer->entries);
+    json_decref(writer->uris);
+    free(writer->fileName);
+    free(writer->tempName);
+    free(writer);
+}
+
+static bool mapSnapshotFile(const char* fileName, redfishSnapshot* snapshot)
+{
+#ifdef _MSC_VER
+    HANDLE file;
+    LARGE_INTEGER size;
+
+    file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    if(GetFileSizeEx(file, &size) == FALSE || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    snapshot->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if(snapshot->mapping == NULL)
+    {
+        return false;
+    }
+    snapshot->data = (const unsigned char*)MapViewOfFile(snapshot->mapping, FILE_MAP_READ, 0, 0, 0);
+    if(snapshot->data == NULL)
+    {
+        CloseHandle(snapshot->mapping);
+        return false;
+    }
+    snapshot->size = (size_t)size.QuadPart;
+    return true;
+#else
+    struct stat info;
+    void* data;
+    int fd;
+
+    fd = open(fileName, O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+    if(fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+    data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    //The mapping stays valid once the file is closed
+    close(fd);
+    if(data == MAP_FAILED)
+    {
+        return false;
+    }
+    snapshot->data = (const unsigned char*)data;
+    snapshot->size = (size_t)info.st_size;
+    return true;
+#endif
+}
+
+redfishSnapshot* snapshotIncRef(redfishSnapshot* snapshot)
+{
+#ifdef _MSC_VER
+#if _M_AMD64
+    InterlockedIncrement64(&(snapshot->refCount));
+#else
+    InterlockedIncrement(&(snapshot->refCount));
+#endif
+#else
+    __sync_fetch_and_add(&(snapshot->refCount), 1);
+#endif
+    return snapshot;
+}
+
+/*Check that every URI and tape the index points at lies inside the file, the tapes themselves are checked when they are used*/
+static bool validateSnapshotIndex(const unsigned char* data, const snapshotHeader* header)
+{
+    const snapshotIndexEntry* index = (const snapshotIndexEntry*)(data + header->index);
+    uint64_t i;
+
+    for(i = 0; i < header->count; i++)
+    {
+        if(index[i].uri >= header->size || index[i].uriLength >= header->size - index[i].uri ||
+           data[index[i].uri + index[i].uriLength] != '\0' || strlen((const char*)(data + index[i].uri)) != index[i].uriLength)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Index entry %lu has a bad URI\n", __func__, (unsigned long)i);
+            return false;
+        }
+        if(index[i].tape > header->size || index[i].tapeSize > header->size - index[i].tape || (index[i].tape % SNAPSHOT_ALIGN) != 0)
+        {
+            REDFISH_DEBUG_ERR_PRINT("%s: Index entry %lu has a bad tape\n", __func__, (unsigned long)i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*Binary search the index, which is sorted by URI*/
+static const snapshotIndexEntry* findSnapshotEntry(redfishSnapshot* snapshot, const char* uri)
+{
+    const snapshotIndexEntry* entry;
+    size_t low = 0;
+    size_t high;
+    size_t middle;
+    int cmp;
+
+    if(snapshot == NULL || uri == NULL)
+    {
+        return NULL;
+    }
+    high = snapshot->count;
+    while(low < high)
+    {
+        middle = low + ((high - low) / 2);
+        entry = &snapshot->index[middle];
+        cmp = strcmp(uri, (const char*)(snapshot->data + entry->uri));
+        if(cmp == 0)
+        {
+            return entry;
+        }
+        if(cmp < 0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+    return NULL;
+}
+
+static redfishPayload* getEntryPayload(redfishSnapshot* snapshot, const snapshotIndexEntry* entry, redfishService* service)
+{
+    payloadTape* tape;
+    redfishPayload* ret;
+
+    if(entry == NULL)
+    {
+        return NULL;
+    }
+    tape = getEntryTape(snapshot, entry);
+    if(tape == NULL)
+    {
+        return NULL;
+    }
+    ret = createFrozenRedfishPayload(tape, service);
+    if(ret)
+    {
+        ret->responseTime = (unsigned long)entry->responseTime;
+    }
+    return ret;
+}
+
+/*Find the entry a replay service answers uri with, services answer /redfish/v1/ and /redfish/v1 alike*/
+static const snapshotIndexEntry* findReplayEntry(redfishService* service, const char** uri)
+{
+    const snapshotIndexEntry* entry;
+    const char* path = *uri;
+    char* other;
+    size_t hostLength = strlen(service->host);
+    size_t pathLength;
+    size_t length;
+
+    if(strncmp(path, service->host, hostLength) == 0)
+    {
+        path += hostLength;
+        *uri = path;
+    }
+    entry = findSnapshotEntry(service->replay, path);
+    if(entry == NULL)
+    {
+        //The query string stays, a nextLink is only answered if its page was stored
+        length = strlen(path);
+        pathLength = strcspn(path, "?");
+        other = (char*)malloc(length + 2);
+        if(other == NULL)
+        {
+            return NULL;
+        }
+        if(pathLength > 1 && path[pathLength-1] == '/')
+        {
+            memcpy(other, path, pathLength - 1);
+            memcpy(other + pathLength - 1, path + pathLength, length - pathLength + 1);
+        }
+        else
+        {
+            memcpy(other, path, pathLength);
+            other[pathLength] = '/';
+            memcpy(other + pathLength + 1, path + pathLength, length - pathLength + 1);
+        }
+        entry = findSnapshotEntry(service->replay, other);
+        free(other);
+    }
+    return entry;
+}
+
+static payloadTape* getEntryTape(redfishSnapshot* snapshot, const snapshotIndexEntry* entry)
+{
+    payloadTape* tape;
+
+    snapshotIncRef(snapshot);
+    tape = tapeCreateFromBuffer(snapshot->data + entry->tape, entry->tapeSize, snapshotDecRef, snapshot);
+    if(tape == NULL)
+    {
+        snapshotDecRef(snapshot);
+    }
+    return tape;
+}
+
+static void snapshotDecRef(void* context)
+{
+    redfishSnapshot* snapshot = (redfishSnapshot*)context;
+    size_t newCount;
+
+#ifdef _MSC_VER
+#if _M_AMD64
+    newCount = InterlockedDecrement64(&(snapshot->refCount));
+#else
+    newCount = InterlockedDecrement(&(snapshot->refCount));
+#endif
+#else
+    newCount = __sync_sub_and_fetch(&(snapshot->refCount), 1);
+#endif
+    if(newCount != 0)
+    {
+        return;
+    }
+#ifdef _MSC_VER
+    UnmapViewOfFile(snapshot->data);
+    CloseHandle(snapshot->mapping);
+#else
+    munmap((void*)snapshot->data, snapshot->size);
+#endif
+    if(snapshot->service)
+    {
+        serviceDecRef(snapshot->service);
+    }
+    free(snapshot);
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
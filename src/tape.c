@@ -0,0 +1,884 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+#include "tape.h"
+#include "hash.h"
+#include "debug.h"
+
+/** The first bytes of every tape **/
+#define TAPE_MAGIC   "RFTP"
+/** The current tape layout version **/
+#define TAPE_VERSION 2
+/** All nodes start on this boundary **/
+#define TAPE_ALIGN   8
+/** The initial size of the buffer used to build a tape **/
+#define TAPE_INITIAL_SIZE 4096
+
+/** The node types stored on the tape, kept apart from json_type so the layout does not depend on jansson **/
+typedef enum
+{
+    TAPE_NODE_OBJECT = 1,
+    TAPE_NODE_ARRAY,
+    TAPE_NODE_STRING,
+    TAPE_NODE_INTEGER,
+    TAPE_NODE_REAL,
+    TAPE_NODE_TRUE,
+    TAPE_NODE_FALSE,
+    TAPE_NODE_NULL
+} tapeNodeType;
+
+/** The header at the start of the tape **/
+typedef struct
+{
+    /** TAPE_MAGIC **/
+    char magic[4];
+    /** TAPE_VERSION **/
+    uint32_t version;
+    /** The size of the tape in bytes, including this header **/
+    uint32_t size;
+    /** The offset of the root node **/
+    uint32_t root;
+} tapeHeader;
+
+/**
+ * @brief The header at the start of every node.
+ *
+ * Strings are followed by their NUL terminated text, integers by an int64_t, reals by a double, arrays by count uint32_t
+ * node offsets, and objects by count tapeObjectEntry structures in document order followed by count uint32_t entry
+ * positions sorted by member name.
+ */
+typedef struct
+{
+    /** The tapeNodeType of the node **/
+    uint32_t type;
+    /** The string length or the number of members in an object or array **/
+    uint32_t count;
+} tapeNodeHeader;
+
+/** A single object member **/
+typedef struct
+{
+    /** The offset of the NUL terminated member name **/
+    uint32_t key;
+    /** The length of the member name **/
+    uint32_t keyLength;
+    /** The offset of the member's node **/
+    uint32_t value;
+} tapeObjectEntry;
+
+struct _payloadTape
+{
+    /** The number of users of this tape, (size_t)-1 for tapes that are never freed **/
+#ifdef _MSC_VER
+#if _M_AMD64
+    LONG64 refCount;
+#else
+    LONG refCount;
+#endif
+#else
+    size_t refCount;
+#endif
+    /** The size of the tape in bytes **/
+    size_t size;
+    /** The tape itself **/
+    unsigned char* data;
+    /** Called instead of freeing data for tapes that read someone else's buffer **/
+    void (*release)(void* context);
+    /** The context for release **/
+    void* releaseContext;
+};
+
+/** State used while writing a tape **/
+typedef struct
+{
+    /** The tape so far **/
+    unsigned char* data;
+    /** The number of bytes used **/
+    size_t size;
+    /** The number of bytes allocated **/
+    size_t capacity;
+    /** Member names already written to the tape, mapped to their offsets **/
+    json_t* keys;
+    /** Set if anything went wrong **/
+    bool failed;
+} tapeBuilder;
+
+/** An object member waiting to be sorted by name **/
+typedef struct
+{
+    /** The member name **/
+    const char* key;
+    /** The length of the member name **/
+    size_t keyLength;
+    /** The position of the member in the object **/
+    uint32_t position;
+} tapeSortEntry;
+
+static size_t builderReserve(tapeBuilder* builder, size_t length, bool align);
+static size_t builderWriteKey(tapeBuilder* builder, const char* key, size_t keyLength);
+static size_t builderWriteNode(tapeBuilder* builder, json_t* json);
+static size_t builderWriteObject(tapeBuilder* builder, json_t* json);
+static uint32_t getTapeNodeType(json_t* json);
+static int compareSortEntries(const void* a, const void* b);
+static int compareKeys(const char* a, size_t aLength, const char* b, size_t bLength);
+static const tapeNodeHeader* getNode(payloadTape* tape, size_t node);
+static bool validateTape(const unsigned char* data, size_t size, size_t root);
+static bool validateNode(const unsigned char* data, size_t size, size_t node, size_t* children, size_t* childCount, unsigned char* seen);
+static bool queueNode(size_t size, uint64_t node, size_t* pending, size_t* pendingCount, unsigned char* seen);
+
+payloadTape* tapeCreateFromJson(json_t* json)
+{
+    tapeBuilder builder;
+    tapeHeader header;
+    payloadTape* ret;
+    size_t root;
+    unsigned char* shrunk;
+
+    if(json == NULL)
+    {
+        return NULL;
+    }
+    memset(&builder, 0, sizeof(builder));
+    builder.keys = json_object();
+    if(builder.keys == NULL)
+    {
+        return NULL;
+    }
+    builderReserve(&builder, sizeof(tapeHeader), true);
+    root = builderWriteNode(&builder, json);
+    json_decref(builder.keys);
+    if(builder.failed)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Unable to create tape\n", __func__);
+        free(builder.data);
+        return NULL;
+    }
+    memcpy(header.magic, TAPE_MAGIC, 4);
+    header.version = TAPE_VERSION;
+    header.size = (uint32_t)builder.size;
+    header.root = (uint32_t)root;
+    memcpy(builder.data, &header, sizeof(header));
+    //Give back the slack from building
+    shrunk = (unsigned char*)realloc(builder.data, builder.size);
+    if(shrunk != NULL)
+    {
+        builder.data = shrunk;
+    }
+
+    ret = (payloadTape*)calloc(1, sizeof(payloadTape));
+    if(ret == NULL)
+    {
+        free(builder.data);
+        return NULL;
+    }
+    ret->refCount = 1;
+    ret->size = builder.size;
+    ret->data = builder.data;
+    return ret;
+}
+
+payloadTape* tapeCreateFromBuffer(const void* data, size_t size, void (*release)(void* context), void* releaseContext)
+{
+    tapeHeader header;
+    payloadTape* ret;
+
+    if(data == NULL || size < sizeof(header) || ((uintptr_t)data % TAPE_ALIGN) != 0)
+    {
+        return NULL;
+    }
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, TAPE_MAGIC, 4) != 0 || header.version != TAPE_VERSION || header.size > size ||
+       validateTape((const unsigned char*)data, header.size, header.root) == false)
+    {
+        REDFISH_DEBUG_ERR_PRINT("%s: Buffer does not hold a valid tape\n", __func__);
+        return NULL;
+    }
+    ret = (payloadTape*)calloc(1, sizeof(payloadTape));
+    if(ret == NULL)
+    {
+        return NULL;
+    }
+    ret->refCount = 1;
+    ret->size = header.size;
+    //Never written through, the tape accessors are all read only
+    ret->data = (unsigned char*)data;
+    ret->release = release;
+    ret->releaseContext = releaseContext;
+    return ret;
+}
+
+payloadTape* tapeIncRef(payloadTape* tape)
+{
+    if(tape == NULL || tape->refCount == (size_t)-1)
+    {
+        return tape;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    InterlockedIncrement64(&(tape->refCount));
+#else
+    InterlockedIncrement(&(tape->refCount));
+#endif
+#else
+    __sync_fetch_and_add(&(tape->refCount), 1);
+#endif
+    return tape;
+}
+
+void tapeDecRef(payloadTape* tape)
+{
+    size_t newCount;
+
+    if(tape == NULL || tape->refCount == (size_t)-1)
+    {
+        return;
+    }
+#ifdef _MSC_VER
+#if _M_AMD64
+    newCount = InterlockedDecrement64(&(tape->refCount));
+#else
+    newCount = InterlockedDecrement(&(tape->refCount));
+#endif
+#else
+    newCount = __sync_sub_and_fetch(&(tape->refCount), 1);
+#endif
+    if(newCount == 0)
+    {
+        if(tape->release)
+        {
+            tape->release(tape->releaseContext);
+        }
+        else
+        {
+            free(tape->data);
+        }
+        free(tape);
+    }
+}
+
+size_t tapeRoot(payloadTape* tape)
+{
+    tapeHeader header;
+
+    memcpy(&header, tape->data, sizeof(header));
+    return header.root;
+}
+
+const void* tapeData(payloadTape* tape, size_t* size)
+{
+    if(size)
+    {
+        *size = tape->size;
+    }
+    return tape->data;
+}
+
+json_type tapeType(payloadTape* tape, size_t node)
+{
+    switch(getNode(tape, node)->type)
+    {
+        case TAPE_NODE_OBJECT:
+            return JSON_OBJECT;
+        case TAPE_NODE_ARRAY:
+            return JSON_ARRAY;
+        case TAPE_NODE_STRING:
+            return JSON_STRING;
+        case TAPE_NODE_INTEGER:
+            return JSON_INTEGER;
+        case TAPE_NODE_REAL:
+            return JSON_REAL;
+        case TAPE_NODE_TRUE:
+            return JSON_TRUE;
+        case TAPE_NODE_FALSE:
+            return JSON_FALSE;
+        default:
+            return JSON_NULL;
+    }
+}
+
+size_t tapeSize(payloadTape* tape, size_t node)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+
+    if(header->type != TAPE_NODE_OBJECT && header->type != TAPE_NODE_ARRAY)
+    {
+        return 0;
+    }
+    return header->count;
+}
+
+bool tapeObjectGet(payloadTape* tape, size_t node, const char* key, size_t keyLength, size_t* child)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+    const tapeObjectEntry* entries;
+    const uint32_t* sorted;
+    const tapeObjectEntry* entry;
+    uint32_t low = 0;
+    uint32_t high;
+    uint32_t middle;
+    int compare;
+
+    if(header->type != TAPE_NODE_OBJECT)
+    {
+        return false;
+    }
+    entries = (const tapeObjectEntry*)(header+1);
+    sorted = (const uint32_t*)(entries + header->count);
+    high = header->count;
+    while(low < high)
+    {
+        middle = low + (high - low)/2;
+        entry = &entries[sorted[middle]];
+        compare = compareKeys(key, keyLength, (const char*)(tape->data + entry->key), entry->keyLength);
+        if(compare == 0)
+        {
+            *child = entry->value;
+            return true;
+        }
+        if(compare < 0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+    return false;
+}
+
+bool tapeGetByIndex(payloadTape* tape, size_t node, size_t index, const char** key, size_t* child)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+    const tapeObjectEntry* entries;
+    const uint32_t* offsets;
+
+    if((header->type != TAPE_NODE_OBJECT && header->type != TAPE_NODE_ARRAY) || index >= header->count)
+    {
+        return false;
+    }
+    if(header->type == TAPE_NODE_OBJECT)
+    {
+        entries = (const tapeObjectEntry*)(header+1);
+        if(key)
+        {
+            *key = (const char*)(tape->data + entries[index].key);
+        }
+        *child = entries[index].value;
+    }
+    else
+    {
+        offsets = (const uint32_t*)(header+1);
+        if(key)
+        {
+            *key = NULL;
+        }
+        *child = offsets[index];
+    }
+    return true;
+}
+
+const char* tapeStringValue(payloadTape* tape, size_t node, size_t* length)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+
+    if(header->type != TAPE_NODE_STRING)
+    {
+        return NULL;
+    }
+    if(length)
+    {
+        *length = header->count;
+    }
+    return (const char*)(header+1);
+}
+
+json_int_t tapeIntegerValue(payloadTape* tape, size_t node)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+    int64_t value;
+
+    if(header->type != TAPE_NODE_INTEGER)
+    {
+        return 0;
+    }
+    memcpy(&value, header+1, sizeof(value));
+    return (json_int_t)value;
+}
+
+double tapeRealValue(payloadTape* tape, size_t node)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+    double value;
+
+    if(header->type != TAPE_NODE_REAL)
+    {
+        return 0;
+    }
+    memcpy(&value, header+1, sizeof(value));
+    return value;
+}
+
+uint64_t tapeHash(payloadTape* tape, size_t node, const char** ignore)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+    const tapeObjectEntry* entries;
+    const uint32_t* offsets;
+    uint64_t hash = 0;
+    size_t count = 0;
+    int64_t int64Val;
+    double realVal;
+    uint32_t i;
+
+    switch(header->type)
+    {
+        case TAPE_NODE_OBJECT:
+            entries = (const tapeObjectEntry*)(header+1);
+            for(i = 0; i < header->count; i++)
+            {
+                if(hashIgnored((const char*)(tape->data + entries[i].key), ignore) == false)
+                {
+                    hash += hashMember((const char*)(tape->data + entries[i].key), entries[i].keyLength, tapeHash(tape, entries[i].value, ignore));
+                    count++;
+                }
+            }
+            return hashObject(hash, count);
+        case TAPE_NODE_ARRAY:
+            hash = hashArrayStart(header->count);
+            offsets = (const uint32_t*)(header+1);
+            for(i = 0; i < header->count; i++)
+            {
+                hash = hashArrayElement(hash, tapeHash(tape, offsets[i], ignore));
+            }
+            return hash;
+        case TAPE_NODE_STRING:
+            return hashString((const char*)(header+1), header->count);
+        case TAPE_NODE_INTEGER:
+            memcpy(&int64Val, header+1, sizeof(int64Val));
+            return hashInteger(int64Val);
+        case TAPE_NODE_REAL:
+            memcpy(&realVal, header+1, sizeof(realVal));
+            return hashReal(realVal);
+        default:
+            return hashSeed(tapeType(tape, node));
+    }
+}
+
+json_t* tapeToJson(payloadTape* tape, size_t node)
+{
+    const tapeNodeHeader* header = getNode(tape, node);
+    const tapeObjectEntry* entries;
+    const uint32_t* offsets;
+    json_t* ret;
+    json_t* child;
+    json_int_t intVal;
+    int64_t int64Val;
+    double realVal;
+    uint32_t i;
+
+    switch(header->type)
+    {
+        case TAPE_NODE_OBJECT:
+            ret = json_object();
+            entries = (const tapeObjectEntry*)(header+1);
+            for(i = 0; i < header->count && ret != NULL; i++)
+            {
+                child = tapeToJson(tape, entries[i].value);
+                if(child == NULL || json_object_set_new_nocheck(ret, (const char*)(tape->data + entries[i].key), child) != 0)
+                {
+                    json_decref(ret);
+                    ret = NULL;
+                }
+            }
+            return ret;
+        case TAPE_NODE_ARRAY:
+            ret = json_array();
+            offsets = (const uint32_t*)(header+1);
+            for(i = 0; i < header->count && ret != NULL; i++)
+            {
+                child = tapeToJson(tape, offsets[i]);
+                if(child == NULL || json_array_append_new(ret, child) != 0)
+                {
+                    json_decref(ret);
+                    ret = NULL;
+                }
+            }
+            return ret;
+        case TAPE_NODE_STRING:
+            return json_stringn_nocheck((const char*)(header+1), header->count);
+        case TAPE_NODE_INTEGER:
+            memcpy(&int64Val, header+1, sizeof(int64Val));
+            intVal = (json_int_t)int64Val;
+            return json_integer(intVal);
+        case TAPE_NODE_REAL:
+            memcpy(&realVal, header+1, sizeof(realVal));
+            return json_real(realVal);
+        case TAPE_NODE_TRUE:
+            return json_true();
+        case TAPE_NODE_FALSE:
+            return json_false();
+        case TAPE_NODE_NULL:
+            return json_null();
+        default:
+            return NULL;
+    }
+}
+
+static int compareSortEntries(const void* a, const void* b)
+{
+    const tapeSortEntry* first = (const tapeSortEntry*)a;
+    const tapeSortEntry* second = (const tapeSortEntry*)b;
+
+    return compareKeys(first->key, first->keyLength, second->key, second->keyLength);
+}
+
+static int compareKeys(const char* a, size_t aLength, const char* b, size_t bLength)
+{
+    int ret = memcmp(a, b, (aLength < bLength) ? aLength : bLength);
+
+    if(ret != 0 || aLength == bLength)
+    {
+        return ret;
+    }
+    return (aLength < bLength) ? -1 : 1;
+}
+
+static const tapeNodeHeader* getNode(payloadTape* tape, size_t node)
+{
+    return (const tapeNodeHeader*)(tape->data + node);
+}
+
+/*Check every node reachable from the root once so the accessors never have to*/
+static bool validateTape(const unsigned char* data, size_t size, size_t root)
+{
+    size_t* pending;
+    size_t pendingCount = 0;
+    unsigned char* seen;
+    size_t node;
+    bool ret = true;
+
+    //Each node is queued once, and nodes are at least TAPE_ALIGN bytes apart
+    pending = (size_t*)malloc(sizeof(size_t) * (size/TAPE_ALIGN + 1));
+    seen = (unsigned char*)calloc(size/TAPE_ALIGN/8 + 1, 1);
+    if(pending == NULL || seen == NULL)
+    {
+        free(pending);
+        free(seen);
+        return false;
+    }
+    ret = queueNode(size, root, pending, &pendingCount, seen);
+    while(pendingCount && ret)
+    {
+        node = pending[--pendingCount];
+        ret = validateNode(data, size, node, pending, &pendingCount, seen);
+    }
+    free(pending);
+    free(seen);
+    return ret;
+}
+
+/*Check one node, queueing any children not already seen*/
+static bool validateNode(const unsigned char* data, size_t size, size_t node, size_t* children, size_t* childCount, unsigned char* seen)
+{
+    tapeNodeHeader header;
+    tapeObjectEntry entry;
+    uint32_t offset;
+    uint32_t position;
+    uint64_t end;
+    uint32_t i;
+
+    memcpy(&header, data + node, sizeof(header));
+    end = (uint64_t)node + sizeof(header);
+    switch(header.type)
+    {
+        case TAPE_NODE_OBJECT:
+            if(end + (uint64_t)header.count*(sizeof(tapeObjectEntry)+sizeof(uint32_t)) > size)
+            {
+                return false;
+            }
+            for(i = 0; i < header.count; i++)
+            {
+                memcpy(&entry, data + end + i*sizeof(entry), sizeof(entry));
+                memcpy(&position, data + end + header.count*sizeof(entry) + i*sizeof(uint32_t), sizeof(position));
+                if((uint64_t)entry.key + entry.keyLength >= size || data[entry.key + entry.keyLength] != '\0' || position >= header.count)
+                {
+                    return false;
+                }
+                if(queueNode(size, entry.value, children, childCount, seen) == false)
+                {
+                    return false;
+                }
+            }
+            return true;
+        case TAPE_NODE_ARRAY:
+            if(end + (uint64_t)header.count*sizeof(uint32_t) > size)
+            {
+                return false;
+            }
+            for(i = 0; i < header.count; i++)
+            {
+                memcpy(&offset, data + end + i*sizeof(uint32_t), sizeof(offset));
+                if(queueNode(size, offset, children, childCount, seen) == false)
+                {
+                    return false;
+                }
+            }
+            return true;
+        case TAPE_NODE_STRING:
+            return (end + header.count < size && data[end + header.count] == '\0');
+        case TAPE_NODE_INTEGER:
+            return (end + sizeof(int64_t) <= size);
+        case TAPE_NODE_REAL:
+            return (end + sizeof(double) <= size);
+        case TAPE_NODE_TRUE:
+        case TAPE_NODE_FALSE:
+        case TAPE_NODE_NULL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*Check that a node offset can hold a node header and queue it for validateNode(), the builder never shares nodes so one reached twice (i.e. a cycle) is corrupt*/
+static bool queueNode(size_t size, uint64_t node, size_t* pending, size_t* pendingCount, unsigned char* seen)
+{
+    size_t bit;
+
+    if(node < sizeof(tapeHeader) || (node % TAPE_ALIGN) != 0 || node + sizeof(tapeNodeHeader) > size)
+    {
+        return false;
+    }
+    bit = (size_t)node/TAPE_ALIGN;
+    if(seen[bit/8] & (1 << (bit%8)))
+    {
+        return false;
+    }
+    seen[bit/8] |= (unsigned char)(1 << (bit%8));
+    pending[(*pendingCount)++] = (size_t)node;
+    return true;
+}
+
+static size_t builderReserve(tapeBuilder* builder, size_t length, bool align)
+{
+    size_t offset = builder->size;
+    size_t newCapacity;
+    unsigned char* tmp;
+
+    if(builder->failed)
+    {
+        return 0;
+    }
+    if(align)
+    {
+        offset = (offset + TAPE_ALIGN - 1) & ~((size_t)TAPE_ALIGN - 1);
+    }
+    if(offset + length > UINT32_MAX)
+    {
+        //Offsets are 32 bits
+        builder->failed = true;
+        return 0;
+    }
+    if(offset + length > builder->capacity)
+    {
+        newCapacity = builder->capacity ? builder->capacity : TAPE_INITIAL_SIZE;
+        while(newCapacity < offset + length)
+        {
+            newCapacity *= 2;
+        }
+        tmp = (unsigned char*)realloc(builder->data, newCapacity);
+        if(tmp == NULL)
+        {
+            builder->failed = true;
+            return 0;
+        }
+        builder->data = tmp;
+        builder->capacity = newCapacity;
+    }
+    //Zero any alignment padding so identical trees produce identical tapes
+    memset(builder->data + builder->size, 0, offset + length - builder->size);
+    builder->size = offset + length;
+    return offset;
+}
+
+static size_t builderWriteKey(tapeBuilder* builder, const char* key, size_t keyLength)
+{
+    json_t* existing;
+    size_t offset;
+
+    //The same few names show up over and over in Redfish, only write each one once
+    existing = json_object_get(builder->keys, key);
+    if(existing)
+    {
+        return (size_t)json_integer_value(existing);
+    }
+    offset = builderReserve(builder, keyLength+1, false);
+    if(builder->failed)
+    {
+        return 0;
+    }
+    memcpy(builder->data + offset, key, keyLength+1);
+    json_object_set_new(builder->keys, key, json_integer((json_int_t)offset));
+    return offset;
+}
+
+static size_t builderWriteNode(tapeBuilder* builder, json_t* json)
+{
+    tapeNodeHeader header;
+    size_t offset;
+    size_t length;
+    size_t i;
+    uint32_t childOffset;
+    int64_t int64Val;
+    double realVal;
+    json_t* value;
+
+    header.type = getTapeNodeType(json);
+    header.count = 0;
+    switch(json_typeof(json))
+    {
+        case JSON_OBJECT:
+            return builderWriteObject(builder, json);
+        case JSON_ARRAY:
+            header.count = (uint32_t)json_array_size(json);
+            offset = builderReserve(builder, sizeof(header) + header.count*sizeof(uint32_t), true);
+            if(builder->failed)
+            {
+                return 0;
+            }
+            memcpy(builder->data + offset, &header, sizeof(header));
+            json_array_foreach(json, i, value)
+            {
+                childOffset = (uint32_t)builderWriteNode(builder, value);
+                if(builder->failed)
+                {
+                    return 0;
+                }
+                memcpy(builder->data + offset + sizeof(header) + i*sizeof(uint32_t), &childOffset, sizeof(childOffset));
+            }
+            return offset;
+        case JSON_STRING:
+            length = json_string_length(json);
+            header.count = (uint32_t)length;
+            offset = builderReserve(builder, sizeof(header) + length + 1, true);
+            if(builder->failed)
+            {
+                return 0;
+            }
+            memcpy(builder->data + offset, &header, sizeof(header));
+            memcpy(builder->data + offset + sizeof(header), json_string_value(json), length+1);
+            return offset;
+        case JSON_INTEGER:
+            offset = builderReserve(builder, sizeof(header) + sizeof(int64Val), true);
+            if(builder->failed)
+            {
+                return 0;
+            }
+            int64Val = (int64_t)json_integer_value(json);
+            memcpy(builder->data + offset, &header, sizeof(header));
+            memcpy(builder->data + offset + sizeof(header), &int64Val, sizeof(int64Val));
+            return offset;
+        case JSON_REAL:
+            offset = builderReserve(builder, sizeof(header) + sizeof(realVal), true);
+            if(builder->failed)
+            {
+                return 0;
+            }
+            realVal = json_real_value(json);
+            memcpy(builder->data + offset, &header, sizeof(header));
+            memcpy(builder->data + offset + sizeof(header), &realVal, sizeof(realVal));
+            return offset;
+        default:
+            offset = builderReserve(builder, sizeof(header), true);
+            if(builder->failed)
+            {
+                return 0;
+            }
+            memcpy(builder->data + offset, &header, sizeof(header));
+            return offset;
+    }
+}
+
+static size_t builderWriteObject(tapeBuilder* builder, json_t* json)
+{
+    tapeNodeHeader header;
+    tapeObjectEntry entry;
+    tapeSortEntry* sorted;
+    size_t offset;
+    size_t i;
+    const char* key;
+    json_t* value;
+
+    header.type = TAPE_NODE_OBJECT;
+    header.count = (uint32_t)json_object_size(json);
+    offset = builderReserve(builder, sizeof(header) + header.count*(sizeof(tapeObjectEntry)+sizeof(uint32_t)), true);
+    if(builder->failed)
+    {
+        return 0;
+    }
+    sorted = (tapeSortEntry*)malloc(sizeof(tapeSortEntry)*(header.count ? header.count : 1));
+    if(sorted == NULL)
+    {
+        builder->failed = true;
+        return 0;
+    }
+    memcpy(builder->data + offset, &header, sizeof(header));
+    i = 0;
+    json_object_foreach(json, key, value)
+    {
+        sorted[i].key = key;
+        sorted[i].keyLength = strlen(key);
+        sorted[i].position = (uint32_t)i;
+        entry.key = (uint32_t)builderWriteKey(builder, key, sorted[i].keyLength);
+        entry.keyLength = (uint32_t)sorted[i].keyLength;
+        entry.value = (uint32_t)builderWriteNode(builder, value);
+        if(builder->failed)
+        {
+            free(sorted);
+            return 0;
+        }
+        //The buffer may have moved, so always go through the offset
+        memcpy(builder->data + offset + sizeof(header) + i*sizeof(entry), &entry, sizeof(entry));
+        i++;
+    }
+    //Members stay in document order, the positions after them are sorted by name for tapeObjectGet()
+    qsort(sorted, header.count, sizeof(tapeSortEntry), compareSortEntries);
+    for(i = 0; i < header.count; i++)
+    {
+        memcpy(builder->data + offset + sizeof(header) + header.count*sizeof(entry) + i*sizeof(uint32_t), &sorted[i].position, sizeof(uint32_t));
+    }
+    free(sorted);
+    return offset;
+}
+
+static uint32_t getTapeNodeType(json_t* json)
+{
+    switch(json_typeof(json))
+    {
+        case JSON_OBJECT:
+            return TAPE_NODE_OBJECT;
+        case JSON_ARRAY:
+            return TAPE_NODE_ARRAY;
+        case JSON_STRING:
+            return TAPE_NODE_STRING;
+        case JSON_INTEGER:
+            return TAPE_NODE_INTEGER;
+        case JSON_REAL:
+            return TAPE_NODE_REAL;
+        case JSON_TRUE:
+            return TAPE_NODE_TRUE;
+        case JSON_FALSE:
+            return TAPE_NODE_FALSE;
+        default:
+            return TAPE_NODE_NULL;
+    }
+}
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */
@@ -0,0 +1,178 @@
+//----------------------------------------------------------------------------
+// Copyright Notice:
+// Copyright 2026 DMTF. All rights reserved.
+// License: BSD 3-Clause License. For full text see link: https://github.com/DMTF/libredfish/blob/main/LICENSE.md
+//----------------------------------------------------------------------------
+
+/**
+ * @file tape.h
+ * @brief File containing the interface for frozen payload tapes.
+ *
+ * This file explains the interface for the compact read only representation of a JSON tree used by frozen payloads.
+ *
+ * A tape is a single contiguous buffer. All references inside it are offsets from the start of the buffer so it can be
+ * copied, written to disk, or mapped into memory as is. Nodes are identified by their offset into the tape.
+ */
+#ifndef _TAPE_H_
+#define _TAPE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <jansson.h>
+
+/** A frozen JSON tree, redfishPayload refers to this by its struct name **/
+typedef struct _payloadTape payloadTape;
+
+/**
+ * @brief Create a tape from a JSON tree
+ *
+ * @param json The tree to freeze
+ * @return A new tape with a reference count of 1 or NULL on error
+ */
+payloadTape* tapeCreateFromJson(json_t* json);
+
+/**
+ * @brief Create a tape that reads a buffer in place, such as one mapped from a file
+ *
+ * The buffer is not copied and must stay valid until release is called, which happens when the last reference to the tape
+ * is dropped. Every node reachable from the root is checked once here so a corrupt buffer is rejected instead of being read
+ * out of bounds later.
+ *
+ * @param data The tape bytes as returned by tapeData(), must be 8 byte aligned
+ * @param size The number of bytes available at data
+ * @param release Called with releaseContext when the tape is freed, may be NULL
+ * @param releaseContext The context for release
+ * @return A new tape with a reference count of 1 or NULL if data does not hold a valid tape
+ */
+payloadTape* tapeCreateFromBuffer(const void* data, size_t size, void (*release)(void* context), void* releaseContext);
+
+/**
+ * @brief Add a reference to a tape
+ *
+ * @param tape The tape to reference, may be NULL
+ * @return The tape
+ */
+payloadTape* tapeIncRef(payloadTape* tape);
+
+/**
+ * @brief Drop a reference to a tape, freeing it once the last reference is gone
+ *
+ * @param tape The tape to release, may be NULL
+ */
+void tapeDecRef(payloadTape* tape);
+
+/**
+ * @brief Get the root node of a tape
+ *
+ * @param tape The tape
+ * @return The root node
+ */
+size_t tapeRoot(payloadTape* tape);
+
+/**
+ * @brief Get the raw bytes of a tape
+ *
+ * @param tape The tape
+ * @param size Filled in with the size of the tape in bytes
+ * @return The start of the tape
+ */
+const void* tapeData(payloadTape* tape, size_t* size);
+
+/**
+ * @brief Get the type of a node
+ *
+ * @param tape The tape
+ * @param node The node
+ * @return The type of the node, using the jansson type values
+ */
+json_type tapeType(payloadTape* tape, size_t node);
+
+/**
+ * @brief Get the number of members in an object or array node
+ *
+ * @param tape The tape
+ * @param node The node
+ * @return The member count, or 0 if the node is not an object or array
+ */
+size_t tapeSize(payloadTape* tape, size_t node);
+
+/**
+ * @brief Find a member of an object node by name
+ *
+ * Members are kept sorted by name on the tape so this is a binary search.
+ *
+ * @param tape The tape
+ * @param node The object node
+ * @param key The member name
+ * @param keyLength The length of the member name
+ * @param child Filled in with the member's node
+ * @return True if the member exists, false otherwise
+ */
+bool tapeObjectGet(payloadTape* tape, size_t node, const char* key, size_t keyLength, size_t* child);
+
+/**
+ * @brief Get a member of an object or array node by position
+ *
+ * Object members keep the order they had in the JSON the tape was created from.
+ *
+ * @param tape The tape
+ * @param node The object or array node
+ * @param index The position of the member
+ * @param key Filled in with the member name for objects or NULL for arrays, may be NULL
+ * @param child Filled in with the member's node
+ * @return True if the member exists, false otherwise
+ */
+bool tapeGetByIndex(payloadTape* tape, size_t node, size_t index, const char** key, size_t* child);
+
+/**
+ * @brief Get the value of a string node
+ *
+ * @param tape The tape
+ * @param node The string node
+ * @param length Filled in with the length of the string, may be NULL
+ * @return The NUL terminated string or NULL if the node is not a string
+ */
+const char* tapeStringValue(payloadTape* tape, size_t node, size_t* length);
+
+/**
+ * @brief Get the value of an integer node
+ *
+ * @param tape The tape
+ * @param node The integer node
+ * @return The value or 0 if the node is not an integer
+ */
+json_int_t tapeIntegerValue(payloadTape* tape, size_t node);
+
+/**
+ * @brief Get the value of a real node
+ *
+ * @param tape The tape
+ * @param node The real node
+ * @return The value or 0 if the node is not a real
+ */
+double tapeRealValue(payloadTape* tape, size_t node);
+
+/**
+ * @brief Get a hash of the content of a node
+ *
+ * The hash is the same as jsonHash() of the same content, see hash.h.
+ *
+ * @param tape The tape
+ * @param node The node to hash, along with everything under it
+ * @param ignore NULL terminated list of member names to leave out at any depth, may be NULL
+ * @return The hash
+ */
+uint64_t tapeHash(payloadTape* tape, size_t node, const char** ignore);
+
+/**
+ * @brief Build a jansson tree for a node
+ *
+ * @param tape The tape
+ * @param node The node to convert, along with everything under it
+ * @return A new JSON value or NULL on error
+ */
+json_t* tapeToJson(payloadTape* tape, size_t node);
+
+#endif
+/* vim: set tabstop=4 shiftwidth=4 ff=unix expandtab: */